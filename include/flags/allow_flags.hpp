@@ -2,6 +2,9 @@
 #define ENUM_CLASS_ALLOW_FLAGS_HPP
 
 
+#include "preprocessor.hpp"
+
+#include <cstddef>
 #include <type_traits>
 
 
@@ -12,6 +15,51 @@ template <class E, class Enabler = void> struct is_flags
 : public std::false_type {};
 
 
+template <class E, class Enabler = void> struct is_wide_flags
+: public std::false_type {};
+
+
+namespace detail {
+
+template <class E>
+using enum_impl_type =
+  typename std::make_unsigned<typename std::underlying_type<E>::type>::type;
+
+
+template <class Impl> struct enum_entry {
+  const char *name;
+  std::size_t length;
+  Impl value;
+};
+
+} // namespace detail
+
+
+// Bits of the underlying type that name enumerators of E. Unless the enum is
+// allowed with ALLOW_FLAGS_FOR_ENUM_VALUES, every bit is assumed valid.
+template <class E, class Enabler = void> struct enum_mask
+: public std::integral_constant<detail::enum_impl_type<E>,
+                                static_cast<detail::enum_impl_type<E>>(
+                                  ~detail::enum_impl_type<E>{0})> {};
+
+
+// Names and values of the enumerators of E, in declaration order, when
+// declared with ALLOW_FLAGS_FOR_ENUM_VALUES; see names.hpp.
+template <class E, class Enabler = void> struct enum_names {
+  static constexpr std::size_t count = 0;
+  // a placeholder, so that code indexing entries compiles for every enum
+  static constexpr detail::enum_entry<detail::enum_impl_type<E>>
+  entries[1] = {{"", 0, 0}};
+};
+
+template <class E, class Enabler>
+constexpr std::size_t enum_names<E, Enabler>::count;
+
+template <class E, class Enabler>
+constexpr detail::enum_entry<detail::enum_impl_type<E>>
+enum_names<E, Enabler>::entries[1];
+
+
 } // namespace flags
 
 
@@ -21,4 +69,47 @@ template <> struct is_flags< name > : std::true_type {}; \
 }
 
 
+// Like ALLOW_FLAGS_FOR_ENUM, also declaring the enumerators of the enum by
+// their unqualified names (at most 64 of them), e.g.
+//   ALLOW_FLAGS_FOR_ENUM_VALUES(Color, Red, Green, Blue)
+#define ALLOW_FLAGS_FOR_ENUM_VALUES(name, ...) \
+ALLOW_FLAGS_FOR_ENUM(name) \
+namespace flags { \
+template <> struct enum_mask< name > \
+: std::integral_constant<detail::enum_impl_type< name >, \
+                         static_cast<detail::enum_impl_type< name >>(0 \
+  ENUM_CLASS_FLAGS_FOR_EACH(ENUM_CLASS_FLAGS_ENUM_BIT, name, __VA_ARGS__))> \
+{}; \
+template <class Enabler> struct enum_names< name, Enabler > { \
+  static constexpr std::size_t count = \
+    ENUM_CLASS_FLAGS_NARG(__VA_ARGS__); \
+  static constexpr detail::enum_entry<detail::enum_impl_type< name >> \
+  entries[] = { \
+    ENUM_CLASS_FLAGS_FOR_EACH(ENUM_CLASS_FLAGS_ENUM_ENTRY, name, \
+                              __VA_ARGS__) \
+  }; \
+}; \
+template <class Enabler> \
+constexpr std::size_t enum_names< name, Enabler >::count; \
+template <class Enabler> \
+constexpr detail::enum_entry<detail::enum_impl_type< name >> \
+enum_names< name, Enabler >::entries[]; \
+}
+
+#define ENUM_CLASS_FLAGS_ENUM_BIT(name, value) \
+  | static_cast<detail::enum_impl_type< name >>(name::value)
+
+#define ENUM_CLASS_FLAGS_ENUM_ENTRY(name, value) \
+  {#value, sizeof(#value) - 1, \
+   static_cast<detail::enum_impl_type< name >>(name::value)},
+
+
+// Enumerators of enums allowed for wide_flags are bit indices rather than
+// single-bit masks.
+#define ALLOW_WIDE_FLAGS_FOR_ENUM(name) \
+namespace flags { \
+template <> struct is_wide_flags< name > : std::true_type {}; \
+}
+
+
 #endif // ENUM_CLASS_ALLOW_FLAGS_HPP
@@ -0,0 +1,202 @@
+#ifndef ENUM_CLASS_ATOMIC_FLAGS_HPP
+#define ENUM_CLASS_ATOMIC_FLAGS_HPP
+
+
+#include "flags.hpp"
+
+#include <atomic>
+#include <type_traits>
+
+
+namespace flags {
+namespace detail {
+
+
+// Whether std::atomic of an unsigned integer of Size bytes is always
+// lock-free on this target.
+template <std::size_t Size> struct atomic_always_lock_free;
+
+template <> struct atomic_always_lock_free<1>
+: std::integral_constant<bool, ATOMIC_CHAR_LOCK_FREE == 2> {};
+
+template <> struct atomic_always_lock_free<2>
+: std::integral_constant<bool, ATOMIC_SHORT_LOCK_FREE == 2> {};
+
+template <> struct atomic_always_lock_free<4>
+: std::integral_constant<bool, ATOMIC_INT_LOCK_FREE == 2> {};
+
+template <> struct atomic_always_lock_free<8>
+: std::integral_constant<bool, ATOMIC_LLONG_LOCK_FREE == 2> {};
+
+
+} // namespace detail
+
+
+// flags<E> stored in a std::atomic. Every operation is a single atomic
+// instruction (or a compare-exchange loop where the target has no
+// dedicated one) and takes the same memory order arguments as the
+// corresponding std::atomic member.
+template <class E> class atomic_flags {
+public:
+  using flags_type = flags<E>;
+  using enum_type = typename flags_type::enum_type;
+  using underlying_type = typename flags_type::underlying_type;
+  using impl_type = typename flags_type::impl_type;
+
+  static_assert(detail::atomic_always_lock_free<sizeof(impl_type)>::value,
+                "flags::atomic_flags requires lock-free atomics "
+                "of the enum's size");
+
+  static constexpr bool is_always_lock_free = true;
+
+
+  atomic_flags() noexcept : value_(0) {}
+
+  constexpr atomic_flags(flags_type fl) noexcept : value_(raw(fl)) {}
+
+  atomic_flags(const atomic_flags &) = delete;
+  atomic_flags &operator=(const atomic_flags &) = delete;
+
+  flags_type operator=(flags_type fl) noexcept {
+    store(fl);
+    return fl;
+  }
+
+
+  bool is_lock_free() const noexcept { return value_.is_lock_free(); }
+
+
+  flags_type load(std::memory_order order = std::memory_order_seq_cst)
+  const noexcept {
+    return to_flags(value_.load(order));
+  }
+
+  operator flags_type() const noexcept { return load(); }
+
+  void store(flags_type fl,
+             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    value_.store(raw(fl), order);
+  }
+
+  flags_type exchange(flags_type fl,
+                      std::memory_order order = std::memory_order_seq_cst)
+  noexcept {
+    return to_flags(value_.exchange(raw(fl), order));
+  }
+
+
+  // Each of these returns the value held immediately before the operation.
+  flags_type fetch_insert(flags_type fl,
+                          std::memory_order order = std::memory_order_seq_cst)
+  noexcept {
+    return to_flags(value_.fetch_or(raw(fl), order));
+  }
+
+  flags_type fetch_erase(flags_type fl,
+                         std::memory_order order = std::memory_order_seq_cst)
+  noexcept {
+    return to_flags(value_.fetch_and(static_cast<impl_type>(~raw(fl)),
+                                     order));
+  }
+
+  flags_type fetch_toggle(flags_type fl,
+                          std::memory_order order = std::memory_order_seq_cst)
+  noexcept {
+    return to_flags(value_.fetch_xor(raw(fl), order));
+  }
+
+
+  // Inserts e and returns whether it was absent, i.e. whether this call
+  // won the race against any other thread inserting it.
+  bool test_and_insert(enum_type e,
+                       std::memory_order order = std::memory_order_seq_cst)
+  noexcept {
+    const auto bit = static_cast<impl_type>(e);
+    return !(value_.fetch_or(bit, order) & bit);
+  }
+
+  // Erases e and returns whether it was present.
+  bool test_and_erase(enum_type e,
+                      std::memory_order order = std::memory_order_seq_cst)
+  noexcept {
+    const auto bit = static_cast<impl_type>(e);
+    return (value_.fetch_and(static_cast<impl_type>(~bit), order) & bit) != 0;
+  }
+
+
+  bool compare_exchange_weak(flags_type &expected, flags_type desired,
+                             std::memory_order success,
+                             std::memory_order failure) noexcept {
+    impl_type raw_expected = raw(expected);
+    const bool exchanged = value_.compare_exchange_weak(
+      raw_expected, raw(desired), success, failure);
+    expected = to_flags(raw_expected);
+    return exchanged;
+  }
+
+  bool compare_exchange_weak(
+    flags_type &expected, flags_type desired,
+    std::memory_order order = std::memory_order_seq_cst) noexcept {
+    impl_type raw_expected = raw(expected);
+    const bool exchanged = value_.compare_exchange_weak(
+      raw_expected, raw(desired), order);
+    expected = to_flags(raw_expected);
+    return exchanged;
+  }
+
+  bool compare_exchange_strong(flags_type &expected, flags_type desired,
+                               std::memory_order success,
+                               std::memory_order failure) noexcept {
+    impl_type raw_expected = raw(expected);
+    const bool exchanged = value_.compare_exchange_strong(
+      raw_expected, raw(desired), success, failure);
+    expected = to_flags(raw_expected);
+    return exchanged;
+  }
+
+  bool compare_exchange_strong(
+    flags_type &expected, flags_type desired,
+    std::memory_order order = std::memory_order_seq_cst) noexcept {
+    impl_type raw_expected = raw(expected);
+    const bool exchanged = value_.compare_exchange_strong(
+      raw_expected, raw(desired), order);
+    expected = to_flags(raw_expected);
+    return exchanged;
+  }
+
+
+#ifdef __cpp_lib_atomic_wait
+  // Blocks while the held value equals old.
+  void wait(flags_type old,
+            std::memory_order order = std::memory_order_seq_cst)
+  const noexcept {
+    value_.wait(raw(old), order);
+  }
+
+  void notify_one() noexcept { value_.notify_one(); }
+  void notify_all() noexcept { value_.notify_all(); }
+#endif
+
+private:
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  static flags_type to_flags(impl_type value) noexcept {
+    flags_type fl{empty_t{}};
+    fl.set_underlying_value(static_cast<underlying_type>(value));
+    return fl;
+  }
+
+
+  std::atomic<impl_type> value_;
+};
+
+
+template <class E> constexpr bool atomic_flags<E>::is_always_lock_free;
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_ATOMIC_FLAGS_HPP
@@ -0,0 +1,234 @@
+#ifndef ENUM_CLASS_BITS_HPP
+#define ENUM_CLASS_BITS_HPP
+
+
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+
+
+// Compilers inline __builtin_popcount as a single instruction only when the
+// target has one; on plain x86 it becomes a libgcc call which is slower than
+// the SWAR sequence below.
+#if defined(__GNUC__) \
+    && (defined(__POPCNT__) || !(defined(__x86_64__) || defined(__i386__)))
+#  define ENUM_CLASS_FLAGS_HAS_BUILTIN_POPCOUNT
+#endif
+
+#if defined(__BMI2__) && (defined(__x86_64__) || defined(_M_X64))
+#  define ENUM_CLASS_FLAGS_HAS_BMI2
+#  include <immintrin.h>
+#endif
+
+
+namespace flags {
+namespace detail {
+
+
+// Single-bit arithmetic on the unsigned impl_type of flags. All of these are
+// branch-free and usable in C++11 constant expressions.
+
+template <class T>
+constexpr T lowest_bit(T x) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+  return static_cast<T>(x & (~x + 1));
+}
+
+template <class T>
+constexpr T clear_lowest_bit(T x) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+  return static_cast<T>(x & (x - 1));
+}
+
+// Bits of x strictly above the single bit b. If b is zero, so is the result.
+template <class T>
+constexpr T bits_above(T x, T b) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+  return static_cast<T>(x & ~(b | (b - 1)));
+}
+
+
+// Population count, hardware-backed where the target allows it.
+
+constexpr std::uint64_t swar_pairs(std::uint64_t x) noexcept {
+  return x - ((x >> 1) & 0x5555555555555555u);
+}
+
+constexpr std::uint64_t swar_nibbles(std::uint64_t x) noexcept {
+  return (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+}
+
+constexpr std::uint64_t swar_bytes_sum(std::uint64_t x) noexcept {
+  return (((x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fu) * 0x0101010101010101u) >> 56;
+}
+
+constexpr int popcount_swar(std::uint64_t x) noexcept {
+  return static_cast<int>(swar_bytes_sum(swar_nibbles(swar_pairs(x))));
+}
+
+template <class T>
+constexpr int popcount(T x) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+#ifdef ENUM_CLASS_FLAGS_HAS_BUILTIN_POPCOUNT
+  return __builtin_popcountll(x);
+#else
+  return popcount_swar(x);
+#endif
+}
+
+
+// Index of the lowest set bit, or the width of T if there is none.
+template <class T>
+constexpr int countr_zero(T x) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+#ifdef __GNUC__
+  return x ? __builtin_ctzll(x) : static_cast<int>(sizeof(T) * CHAR_BIT);
+#else
+  return popcount(static_cast<T>(lowest_bit(x) - 1));
+#endif
+}
+
+
+// Number of bits needed to represent x, i.e. one past the index of its
+// highest set bit, or zero if x is zero.
+template <class T>
+constexpr int bit_width(T x) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+#ifdef __GNUC__
+  return x ? 64 - __builtin_clzll(x) : 0;
+#else
+  return x ? 1 + bit_width(static_cast<T>(x >> 1)) : 0;
+#endif
+}
+
+// Number of zero bits above the highest set bit, or the width of T if
+// there is none.
+template <class T>
+constexpr int countl_zero(T x) noexcept {
+  return static_cast<int>(sizeof(T) * CHAR_BIT) - bit_width(x);
+}
+
+// The highest set bit of x, or zero.
+template <class T>
+constexpr T highest_bit(T x) noexcept {
+  return x ? static_cast<T>(T{1} << (bit_width(x) - 1)) : T{0};
+}
+
+
+// Broadword select (after Vigna): index of the set bit of rank k, counting
+// from zero, of a 64-bit word with more than k set bits. Prefix sums of
+// the byte counts find the byte holding the bit; the bit is found in the
+// byte by clearing its lower bits.
+
+constexpr std::uint64_t bytes_lsb = 0x0101010101010101u;
+constexpr std::uint64_t bytes_msb = 0x8080808080808080u;
+
+constexpr std::uint64_t byte_prefix_counts(std::uint64_t x) noexcept {
+  return ((swar_nibbles(swar_pairs(x)) + (swar_nibbles(swar_pairs(x)) >> 4))
+          & 0x0f0f0f0f0f0f0f0fu) * bytes_lsb;
+}
+
+constexpr int select_in_byte(unsigned byte, unsigned k) noexcept {
+  return k ? select_in_byte(byte & (byte - 1), k - 1) : countr_zero(byte);
+}
+
+constexpr int select_in_word(std::uint64_t x, unsigned k, std::uint64_t sums,
+                             unsigned place) noexcept {
+  return static_cast<int>(place)
+         + select_in_byte(static_cast<unsigned>(x >> place) & 0xffu,
+                          k - (static_cast<unsigned>((sums << 8) >> place)
+                               & 0xffu));
+}
+
+constexpr unsigned select_byte(std::uint64_t sums, unsigned k) noexcept {
+  // bytes whose prefix count is at most k come before the byte of the bit
+  return static_cast<unsigned>(
+    popcount(((k * bytes_lsb | bytes_msb) - sums) & bytes_msb)) * 8;
+}
+
+constexpr int select_bit(std::uint64_t x, unsigned k) noexcept {
+  return select_in_word(x, k, byte_prefix_counts(x),
+                        select_byte(byte_prefix_counts(x), k));
+}
+
+// select_bit for run time: a single pdep where the target has BMI2.
+inline int select_bit_fast(std::uint64_t x, unsigned k) noexcept {
+#ifdef ENUM_CLASS_FLAGS_HAS_BMI2
+  return countr_zero(static_cast<std::uint64_t>(
+    _pdep_u64(std::uint64_t{1} << k, x)));
+#else
+  return select_bit(x, k);
+#endif
+}
+
+
+// The n lowest set bits of x, or all of them if x has fewer.
+template <class T>
+constexpr T lowest_bits(T x, unsigned n) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+  return n && x ? static_cast<T>(lowest_bit(x)
+                                 | lowest_bits(clear_lowest_bit(x), n - 1))
+                : T{0};
+}
+
+
+// The bits of x at the set bits of mask, packed into the low bits of the
+// result in order (what the BMI2 pext instruction computes).
+template <class T>
+constexpr T extract_bits(T x, T mask, T bit = 1) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+  return mask ? static_cast<T>((x & lowest_bit(mask) ? bit : 0)
+                               | extract_bits(x, clear_lowest_bit(mask),
+                                              static_cast<T>(bit << 1)))
+              : T{0};
+}
+
+// The low bits of x moved, in order, to the set bits of mask (pdep).
+template <class T>
+constexpr T deposit_bits(T x, T mask) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+  return mask ? static_cast<T>((x & 1 ? lowest_bit(mask) : 0)
+                               | deposit_bits(static_cast<T>(x >> 1),
+                                              clear_lowest_bit(mask)))
+              : T{0};
+}
+
+// extract_bits for run time: a single pext where the target has BMI2.
+// (pext is microcoded and slow on AMD processors before Zen 3; builds for
+// those should not enable BMI2.)
+template <class T>
+inline T extract_bits_fast(T x, T mask) noexcept {
+  static_assert(std::is_unsigned<T>::value, "T must be unsigned");
+#ifdef ENUM_CLASS_FLAGS_HAS_BMI2
+  return sizeof(T) <= 4
+         ? static_cast<T>(_pext_u32(static_cast<unsigned>(x),
+                                    static_cast<unsigned>(mask)))
+         : static_cast<T>(_pext_u64(x, mask));
+#else
+  // branch-free: the bits of keys are as good as random
+  T result = 0;
+  for (unsigned n = 0; mask; mask = clear_lowest_bit(mask), ++n) {
+    result |= static_cast<T>(((x >> countr_zero(mask)) & 1u) << n);
+  }
+  return result;
+#endif
+}
+
+
+// Murmur3's 64-bit finalizer. Every input bit affects every output bit,
+// which matters for flags values: they are small and differ in few bits.
+constexpr std::uint64_t xor_shift(std::uint64_t x, int shift) noexcept {
+  return x ^ (x >> shift);
+}
+
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+  return xor_shift(xor_shift(xor_shift(x, 33) * 0xff51afd7ed558ccdu, 33)
+                   * 0xc4ceb9fe1a85ec53u, 33);
+}
+
+
+} // namespace detail
+} // namespace flags
+
+
+#endif // ENUM_CLASS_BITS_HPP
@@ -0,0 +1,257 @@
+#ifndef ENUM_CLASS_CONCURRENT_FLAGS_TABLE_HPP
+#define ENUM_CLASS_CONCURRENT_FLAGS_TABLE_HPP
+
+
+#include "atomic_flags.hpp"
+#include "bits.hpp"
+#include "flags.hpp"
+#include "memory.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace flags {
+namespace detail {
+
+
+template <class Key, bool = std::is_enum<Key>::value>
+struct key_integer {
+  using type = typename std::make_unsigned<Key>::type;
+};
+
+template <class Key> struct key_integer<Key, true> {
+  using type = typename std::make_unsigned<
+    typename std::underlying_type<Key>::type>::type;
+};
+
+
+// The number of keys in one shard, alone on its cache line.
+struct alignas(cache_line_size) shard_size {
+  std::atomic<std::size_t> value{0};
+};
+
+
+} // namespace detail
+
+
+// A fixed-capacity map from integer or enum keys, such as session ids, to
+// flags<E>, updated and read by many threads at once without locks. Each
+// entry is a key word and a flags word, side by side in one array split into
+// shards: the high bits of the hash of a key select its shard, and the
+// key is looked for from the slot given by the low bits onwards, up to the
+// end of the shard and around. A key is inserted by a compare-and-swap of
+// its slot's key word from zero; its flags are then changed with fetch-or
+// and fetch-and on the flags word only.
+//
+// Lookups and changes to the flags of present keys are wait-free: they
+// visit at most one shard and never retry. Inserting a key is lock-free.
+// Keys stay until clear(), and each shard holds at most capacity() /
+// shard_count() of them, so capacity() should be about twice the number of
+// keys for short probes. Every Key value can be stored but the one of 64
+// bits with every bit set, such as -1 for std::int64_t.
+template <class Key, class E> class concurrent_flags_table {
+public:
+  using key_type = Key;
+  using flags_type = flags<E>;
+  using underlying_type = typename flags_type::underlying_type;
+  using impl_type = typename flags_type::impl_type;
+  using size_type = std::size_t;
+
+  static_assert(std::is_integral<Key>::value || std::is_enum<Key>::value,
+                "flags::concurrent_flags_table needs integer or enum keys");
+  static_assert(sizeof(Key) <= sizeof(std::uint64_t),
+                "flags::concurrent_flags_table needs keys of 64 bits "
+                "at most");
+  static_assert(detail::atomic_always_lock_free<sizeof(impl_type)>::value
+                && detail::atomic_always_lock_free<8>::value,
+                "flags::concurrent_flags_table requires lock-free atomics "
+                "of the enum's size and of 64 bits");
+
+
+  // Room for capacity keys, rounded up to a power of two, in shards
+  // shards, also rounded up to a power of two; one shard per hardware
+  // thread by default.
+  explicit concurrent_flags_table(size_type capacity,
+                                  size_type shards = default_shards())
+  : shard_bits_(log2_ceil(shards < 1 ? 1 : shards))
+  , slot_bits_(log2_ceil(capacity < 1 ? 1 : capacity) > shard_bits_
+               ? log2_ceil(capacity) - shard_bits_ : 0)
+  , slots_(new slot[size_type{1} << (shard_bits_ + slot_bits_)])
+  , sizes_(size_type{1} << shard_bits_) {}
+
+  concurrent_flags_table(const concurrent_flags_table &) = delete;
+  concurrent_flags_table &operator=(const concurrent_flags_table &) = delete;
+
+
+  static size_type default_shards() noexcept {
+    const unsigned threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+  }
+
+  size_type capacity() const noexcept {
+    return size_type{1} << (shard_bits_ + slot_bits_);
+  }
+
+  size_type shard_count() const noexcept { return sizes_.size(); }
+
+  // Number of keys; only a recent value while keys are being inserted.
+  size_type size() const noexcept {
+    size_type total = 0;
+    for (const auto &shard : sizes_) {
+      total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+
+  // Adds the flags of mask to those of key, inserting key with no flags
+  // first when absent. Returns false, changing nothing, when key is not
+  // present and its shard is full.
+  bool insert_flags(Key key, flags_type mask) noexcept {
+    const std::uint64_t tag = tag_of(key);
+    if (!tag) { return false; }
+    const std::uint64_t h = detail::mix64(tag);
+    const size_type index = shard_index(h);
+    slot *shard = slots_.get() + (index << slot_bits_);
+    const size_type mask_slots = (size_type{1} << slot_bits_) - 1;
+    for (size_type n = 0, i = h & mask_slots; n <= mask_slots;
+         ++n, i = (i + 1) & mask_slots) {
+      std::uint64_t found = shard[i].tag.load(std::memory_order_acquire);
+      if (!found) {
+        if (shard[i].tag.compare_exchange_strong(
+              found, tag, std::memory_order_acq_rel,
+              std::memory_order_acquire)) {
+          sizes_[index].value.fetch_add(1, std::memory_order_relaxed);
+          found = tag;
+        }
+      }
+      if (found == tag) {
+        shard[i].value.fetch_or(raw(mask), std::memory_order_acq_rel);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Removes the flags of mask from those of key. Returns whether key is
+  // present; it stays so even with no flags left.
+  bool erase_flags(Key key, flags_type mask) noexcept {
+    slot *s = find(key);
+    if (!s) { return false; }
+    s->value.fetch_and(static_cast<impl_type>(~raw(mask)),
+                       std::memory_order_acq_rel);
+    return true;
+  }
+
+
+  // Whether key is present with every flag of mask.
+  bool test(Key key, flags_type mask) const noexcept {
+    const slot *s = find(key);
+    return s && (s->value.load(std::memory_order_acquire) & raw(mask))
+                == raw(mask);
+  }
+
+  // The flags of key, none when absent.
+  flags_type load(Key key) const noexcept {
+    const slot *s = find(key);
+    return to_flags(s ? s->value.load(std::memory_order_acquire) : 0);
+  }
+
+  bool contains(Key key) const noexcept { return find(key) != nullptr; }
+
+
+  // Calls f(key, flags) for every key present when the walk reaches its
+  // slot.
+  template <class F> void for_each(F f) const {
+    for (size_type i = 0; i < capacity(); ++i) {
+      const std::uint64_t tag = slots_[i].tag.load(std::memory_order_acquire);
+      if (tag) {
+        f(static_cast<Key>(static_cast<key_integer>(tag - 1)),
+          to_flags(slots_[i].value.load(std::memory_order_acquire)));
+      }
+    }
+  }
+
+  // Removes every key. Must not run concurrently with other members.
+  void clear() noexcept {
+    for (size_type i = 0; i < capacity(); ++i) {
+      slots_[i].tag.store(0, std::memory_order_relaxed);
+      slots_[i].value.store(0, std::memory_order_relaxed);
+    }
+    for (auto &shard : sizes_) {
+      shard.value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+
+private:
+  using key_integer = typename detail::key_integer<Key>::type;
+
+  // tag is the key plus one, zero while the slot is free.
+  struct slot {
+    std::atomic<std::uint64_t> tag{0};
+    std::atomic<impl_type> value{0};
+  };
+
+
+  static unsigned log2_ceil(size_type n) noexcept {
+    unsigned bits = 0;
+    while ((size_type{1} << bits) < n) { ++bits; }
+    return bits;
+  }
+
+  static std::uint64_t tag_of(Key key) noexcept {
+    return static_cast<std::uint64_t>(static_cast<key_integer>(key)) + 1;
+  }
+
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  static flags_type to_flags(impl_type value) noexcept {
+    flags_type fl{empty_t{}};
+    fl.set_underlying_value(static_cast<underlying_type>(value));
+    return fl;
+  }
+
+  size_type shard_index(std::uint64_t h) const noexcept {
+    return shard_bits_ ? static_cast<size_type>(h >> (64 - shard_bits_)) : 0;
+  }
+
+  slot *find(Key key) const noexcept {
+    const std::uint64_t tag = tag_of(key);
+    if (!tag) { return nullptr; }
+    const std::uint64_t h = detail::mix64(tag);
+    slot *shard = slots_.get() + (shard_index(h) << slot_bits_);
+    const size_type mask_slots = (size_type{1} << slot_bits_) - 1;
+    for (size_type n = 0, i = h & mask_slots; n <= mask_slots;
+         ++n, i = (i + 1) & mask_slots) {
+      const std::uint64_t found =
+        shard[i].tag.load(std::memory_order_acquire);
+      if (found == tag) { return shard + i; }
+      if (!found) { break; }
+    }
+    return nullptr;
+  }
+
+
+  unsigned shard_bits_;
+  unsigned slot_bits_;
+  std::unique_ptr<slot[]> slots_;
+  std::vector<detail::shard_size,
+              detail::aligned_allocator<detail::shard_size>> sizes_;
+};
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_CONCURRENT_FLAGS_TABLE_HPP
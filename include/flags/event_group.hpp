@@ -0,0 +1,352 @@
+#ifndef ENUM_CLASS_EVENT_GROUP_HPP
+#define ENUM_CLASS_EVENT_GROUP_HPP
+
+
+#include "flags.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#  if __has_include(<coroutine>)
+#    define ENUM_CLASS_FLAGS_HAS_COROUTINES
+#    include <coroutine>
+#  endif
+#endif
+
+
+namespace flags {
+namespace detail {
+
+
+// A thread or coroutine blocked on an event_group. Waiters live on the
+// waiting thread's stack or in the coroutine frame and are linked into the
+// group's queue for their condition.
+template <class Impl> struct event_waiter {
+  Impl mask;
+  bool all;
+  bool auto_clear;
+
+  bool ready = false;
+  Impl result = 0;
+  event_waiter *next = nullptr;
+
+  std::condition_variable *cv = nullptr;
+#ifdef ENUM_CLASS_FLAGS_HAS_COROUTINES
+  std::coroutine_handle<> handle;
+#endif
+
+
+  event_waiter(Impl m, bool a, bool c) noexcept
+  : mask(m), all(a), auto_clear(c) {}
+};
+
+
+} // namespace detail
+
+
+// A set of flags that threads and coroutines can wait on, after the event
+// groups of real-time kernels. A wait ends once all (wait_all) or any
+// (wait_any) of the flags of its mask are set, and can then clear those
+// flags atomically with its wake-up (auto_clear).
+//
+// Waiters with the same mask and mode share a queue and are woken in FIFO
+// order. set() only looks at the queues whose mask intersects the flags
+// being set and signals only the waiters it satisfies. Blocked threads each
+// have their own condition variable; coroutines are resumed by the thread
+// calling set(), after it has released the lock.
+template <class E> class event_group {
+public:
+  using flags_type = flags<E>;
+  using enum_type = typename flags_type::enum_type;
+  using underlying_type = typename flags_type::underlying_type;
+  using impl_type = typename flags_type::impl_type;
+
+
+  event_group() noexcept : value_(0) {}
+
+  explicit event_group(flags_type initial) noexcept : value_(raw(initial)) {}
+
+  event_group(const event_group &) = delete;
+  event_group &operator=(const event_group &) = delete;
+
+
+  flags_type get() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return to_flags(value_);
+  }
+
+  // Sets bits, wakes the waiters this satisfies and returns the resulting
+  // value, after any auto-clear done by those waiters.
+  flags_type set(flags_type bits) {
+    waiter *resumable = nullptr;
+    impl_type result;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      value_ |= raw(bits);
+      resumable = wake(raw(bits));
+      result = value_;
+    }
+    resume(resumable);
+    return to_flags(result);
+  }
+
+  // Clears bits and returns the value before clearing.
+  flags_type clear(flags_type bits) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    const impl_type old = value_;
+    value_ &= static_cast<impl_type>(~raw(bits));
+    return to_flags(old);
+  }
+
+
+  // Each wait returns the value of the group at the moment its condition
+  // held, before auto-clear. Like wait_all, wait_any returns at once for an
+  // empty mask, since no flag can ever be set to satisfy it.
+  flags_type wait_all(flags_type mask, bool auto_clear = false) {
+    return wait(raw(mask), true, auto_clear);
+  }
+
+  flags_type wait_any(flags_type mask, bool auto_clear = false) {
+    return wait(raw(mask), false, auto_clear);
+  }
+
+
+  // Timed waits return the current value on timeout; callers tell the two
+  // outcomes apart by testing the returned value against mask.
+  template <class Clock, class Duration>
+  flags_type wait_all_until(
+    flags_type mask, const std::chrono::time_point<Clock, Duration> &deadline,
+    bool auto_clear = false) {
+    return wait_until(raw(mask), true, auto_clear, deadline);
+  }
+
+  template <class Clock, class Duration>
+  flags_type wait_any_until(
+    flags_type mask, const std::chrono::time_point<Clock, Duration> &deadline,
+    bool auto_clear = false) {
+    return wait_until(raw(mask), false, auto_clear, deadline);
+  }
+
+  template <class Rep, class Period>
+  flags_type wait_all_for(flags_type mask,
+                          const std::chrono::duration<Rep, Period> &timeout,
+                          bool auto_clear = false) {
+    return wait_all_until(mask, std::chrono::steady_clock::now() + timeout,
+                          auto_clear);
+  }
+
+  template <class Rep, class Period>
+  flags_type wait_any_for(flags_type mask,
+                          const std::chrono::duration<Rep, Period> &timeout,
+                          bool auto_clear = false) {
+    return wait_any_until(mask, std::chrono::steady_clock::now() + timeout,
+                          auto_clear);
+  }
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_COROUTINES
+  // co_await group.async_wait_all(mask) suspends the coroutine until the
+  // condition holds and yields the same value as wait_all(mask).
+  class awaiter {
+  public:
+    awaiter(event_group &group, impl_type mask, bool all,
+            bool auto_clear) noexcept
+    : group_(group), node_(mask, all, auto_clear) {}
+
+    awaiter(const awaiter &) = delete;
+    awaiter &operator=(const awaiter &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> lock{group_.mutex_};
+      if (group_.satisfied(node_.mask, node_.all)) {
+        node_.result = group_.consume(node_);
+        return false;
+      }
+      node_.handle = handle;
+      group_.enqueue(node_);
+      return true;
+    }
+
+    flags_type await_resume() const noexcept { return to_flags(node_.result); }
+
+  private:
+    event_group &group_;
+    detail::event_waiter<impl_type> node_;
+  };
+
+  awaiter async_wait_all(flags_type mask, bool auto_clear = false) noexcept {
+    return {*this, raw(mask), true, auto_clear};
+  }
+
+  awaiter async_wait_any(flags_type mask, bool auto_clear = false) noexcept {
+    return {*this, raw(mask), false, auto_clear};
+  }
+#endif
+
+private:
+  using waiter = detail::event_waiter<impl_type>;
+
+  struct waiter_queue {
+    impl_type mask;
+    bool all;
+    waiter *head;
+    waiter *tail;
+  };
+
+
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  static flags_type to_flags(impl_type value) noexcept {
+    flags_type fl{empty_t{}};
+    fl.set_underlying_value(static_cast<underlying_type>(value));
+    return fl;
+  }
+
+
+  bool satisfied(impl_type mask, bool all) const noexcept {
+    return all ? (value_ & mask) == mask : (value_ & mask) != 0 || !mask;
+  }
+
+  impl_type consume(const waiter &w) noexcept {
+    const impl_type seen = value_;
+    if (w.auto_clear) { value_ &= static_cast<impl_type>(~w.mask); }
+    return seen;
+  }
+
+
+  void enqueue(waiter &w) {
+    for (auto &queue : queues_) {
+      if (queue.mask == w.mask && queue.all == w.all) {
+        queue.tail->next = &w;
+        queue.tail = &w;
+        return;
+      }
+    }
+    queues_.push_back(waiter_queue{w.mask, w.all, &w, &w});
+  }
+
+  // Unlinks a waiter that gave up before its condition held.
+  void dequeue(waiter &w) noexcept {
+    for (std::size_t i = 0; i < queues_.size(); ++i) {
+      auto &queue = queues_[i];
+      if (queue.mask != w.mask || queue.all != w.all) { continue; }
+
+      waiter *prev = nullptr;
+      for (waiter *node = queue.head; node; prev = node, node = node->next) {
+        if (node != &w) { continue; }
+        (prev ? prev->next : queue.head) = node->next;
+        if (queue.tail == node) { queue.tail = prev; }
+        break;
+      }
+      if (!queue.head) { remove_queue(i); }
+      return;
+    }
+  }
+
+  void remove_queue(std::size_t i) noexcept {
+    queues_[i] = queues_.back();
+    queues_.pop_back();
+  }
+
+
+  // Wakes every waiter satisfied after bits were set. Blocked threads are
+  // notified right away; coroutines are returned as a list to be resumed
+  // once the lock is released.
+  waiter *wake(impl_type bits) noexcept {
+    waiter *resumable = nullptr;
+    waiter **resumable_tail = &resumable;
+
+    for (std::size_t i = 0; i < queues_.size();) {
+      auto &queue = queues_[i];
+      // a condition that does not involve the new bits cannot have changed
+      if (!(queue.mask & bits)) {
+        ++i;
+        continue;
+      }
+
+      while (queue.head && satisfied(queue.mask, queue.all)) {
+        waiter *w = queue.head;
+        queue.head = w->next;
+        w->next = nullptr;
+        w->result = consume(*w);
+        w->ready = true;
+        if (w->cv) {
+          w->cv->notify_one();
+        } else {
+          *resumable_tail = w;
+          resumable_tail = &w->next;
+        }
+      }
+
+      if (queue.head) {
+        ++i;
+      } else {
+        remove_queue(i);
+      }
+    }
+    return resumable;
+  }
+
+  static void resume(waiter *w) noexcept {
+#ifdef ENUM_CLASS_FLAGS_HAS_COROUTINES
+    while (w) {
+      waiter *next = w->next;
+      w->handle.resume();
+      w = next;
+    }
+#else
+    (void)w;
+#endif
+  }
+
+
+  flags_type wait(impl_type mask, bool all, bool auto_clear) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    waiter w{mask, all, auto_clear};
+    if (satisfied(mask, all)) { return to_flags(consume(w)); }
+
+    std::condition_variable cv;
+    w.cv = &cv;
+    enqueue(w);
+    cv.wait(lock, [&w] { return w.ready; });
+    return to_flags(w.result);
+  }
+
+  template <class Clock, class Duration>
+  flags_type wait_until(
+    impl_type mask, bool all, bool auto_clear,
+    const std::chrono::time_point<Clock, Duration> &deadline) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    waiter w{mask, all, auto_clear};
+    if (satisfied(mask, all)) { return to_flags(consume(w)); }
+
+    std::condition_variable cv;
+    w.cv = &cv;
+    enqueue(w);
+    if (!cv.wait_until(lock, deadline, [&w] { return w.ready; })) {
+      dequeue(w);
+      return to_flags(value_);
+    }
+    return to_flags(w.result);
+  }
+
+
+  mutable std::mutex mutex_;
+  impl_type value_;
+  std::vector<waiter_queue> queues_;
+};
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_EVENT_GROUP_HPP
@@ -3,14 +3,26 @@
 
 
 #include "allow_flags.hpp"
+#include "bits.hpp"
 #include "iterator.hpp"
 
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
-#include <numeric>
+#include <iterator>
 #include <utility>
 
 
+#if defined(__cpp_impl_three_way_comparison) && defined(__has_include)
+#  if __has_include(<compare>)
+#    define ENUM_CLASS_FLAGS_HAS_THREE_WAY_COMPARISON
+#    include <compare>
+#  endif
+#endif
+
+
 namespace flags {
 
 
@@ -31,6 +43,8 @@ public:
 
   using iterator = FlagsIterator<enum_type>;
   using const_iterator = iterator;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = reverse_iterator;
   using value_type = typename iterator::value_type;
   using reference = typename iterator::reference;
   using const_reference = typename iterator::reference;
@@ -42,6 +56,11 @@ public:
 
   constexpr static std::size_t bit_size() { return sizeof(impl_type) * 8; }
 
+  // All valid flags; see ALLOW_FLAGS_FOR_ENUM_VALUES.
+  constexpr static flags all() noexcept {
+    return flags{enum_mask<enum_type>::value};
+  }
+
 
 private:
   template <class T, class Res = std::nullptr_t>
@@ -66,14 +85,16 @@ public:
   constexpr flags(enum_type e) noexcept
   : val_(static_cast<impl_type>(e)) {}
 
-  flags &operator=(enum_type e) noexcept {
+  ENUM_CLASS_FLAGS_CONSTEXPR14 flags &operator=(enum_type e) noexcept {
     val_ = static_cast<impl_type>(e);
     return *this;
   }
 
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags(std::initializer_list<enum_type> il) noexcept : val_(0) { insert(il); }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator=(std::initializer_list<enum_type> il) noexcept {
     clear();
     insert(il);
@@ -81,10 +102,12 @@ public:
   }
 
   template <class ... Args>
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags(enum_type e, Args ... args) noexcept : flags{e, args...} {}
 
 
   template <class FwIter>
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags(FwIter b, FwIter e,
         typename convertible<decltype(*b)>::type = nullptr)
   noexcept(noexcept(std::declval<flags>().insert(std::declval<FwIter>(),
@@ -105,35 +128,69 @@ public:
     return fl1.val_ != fl2.val_;
   }
 
+  // Flags order as their values read as unsigned numbers, which puts every
+  // set before its strict supersets; size_order also groups sets by size.
+  friend constexpr bool operator<(flags fl1, flags fl2) noexcept {
+    return fl1.val_ < fl2.val_;
+  }
+
+  friend constexpr bool operator>(flags fl1, flags fl2) noexcept {
+    return fl1.val_ > fl2.val_;
+  }
+
+  friend constexpr bool operator<=(flags fl1, flags fl2) noexcept {
+    return fl1.val_ <= fl2.val_;
+  }
+
+  friend constexpr bool operator>=(flags fl1, flags fl2) noexcept {
+    return fl1.val_ >= fl2.val_;
+  }
 
-  constexpr flags operator~() const noexcept { return flags(~val_); }
+#ifdef ENUM_CLASS_FLAGS_HAS_THREE_WAY_COMPARISON
+  friend constexpr std::strong_ordering operator<=>(flags fl1,
+                                                    flags fl2) noexcept {
+    return fl1.val_ <=> fl2.val_;
+  }
+#endif
 
+
+  // The complement within the valid flags.
+  constexpr flags operator~() const noexcept {
+    return flags(static_cast<impl_type>(~val_ & enum_mask<enum_type>::value));
+  }
+
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator|=(const flags &fl) noexcept {
     val_ |= fl.val_;
     return *this;
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator&=(const flags &fl) noexcept {
     val_ &= fl.val_;
     return *this;
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator^=(const flags &fl) noexcept {
     val_ ^= fl.val_;
     return *this;
   }
 
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator|=(enum_type e) noexcept {
     val_ |= static_cast<impl_type>(e);
     return *this;
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator&=(enum_type e) noexcept {
     val_ &= static_cast<impl_type>(e);
     return *this;
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   flags &operator^=(enum_type e) noexcept {
     val_ ^= static_cast<impl_type>(e);
     return *this;
@@ -152,13 +209,18 @@ public:
   }
 
 
-  void swap(flags &fl) noexcept { std::swap(val_, fl.val_); }
+  ENUM_CLASS_FLAGS_CONSTEXPR14 void swap(flags &fl) noexcept {
+    const impl_type tmp = val_;
+    val_ = fl.val_;
+    fl.val_ = tmp;
+  }
 
 
   constexpr underlying_type underlying_value() const noexcept {
     return static_cast<underlying_type>(val_);
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   void set_underlying_value(underlying_type newval) noexcept {
     val_ = static_cast<impl_type>(newval);
   }
@@ -175,18 +237,45 @@ public:
 
   constexpr bool empty() const noexcept { return !val_; }
 
-  size_type size() const noexcept {
-    return std::distance(this->begin(), this->end());
+  constexpr size_type size() const noexcept {
+    return static_cast<size_type>(detail::popcount(val_));
   }
 
-  constexpr size_type max_size() const noexcept { return bit_size(); }
+  constexpr size_type max_size() const noexcept {
+    return static_cast<size_type>(
+      detail::popcount(enum_mask<enum_type>::value));
+  }
 
 
-  iterator begin() const noexcept { return cbegin(); }
-  iterator cbegin() const noexcept { return iterator{val_}; }
+  constexpr iterator begin() const noexcept { return cbegin(); }
+  constexpr iterator cbegin() const noexcept { return iterator{val_}; }
 
   constexpr iterator end() const noexcept { return cend(); }
-  constexpr iterator cend() const noexcept { return {}; }
+  constexpr iterator cend() const noexcept { return {val_, enum_type{}}; }
+
+  reverse_iterator rbegin() const noexcept { return crbegin(); }
+  reverse_iterator crbegin() const noexcept { return reverse_iterator{end()}; }
+
+  reverse_iterator rend() const noexcept { return crend(); }
+  reverse_iterator crend() const noexcept {
+    return reverse_iterator{begin()};
+  }
+
+
+  // The lowest and the highest flag; the flags must not be empty.
+  constexpr enum_type front() const noexcept {
+    return static_cast<enum_type>(detail::lowest_bit(val_));
+  }
+
+  constexpr enum_type back() const noexcept {
+    return static_cast<enum_type>(detail::highest_bit(val_));
+  }
+
+  // The flag of rank i from the lowest, in constant time; i < size().
+  enum_type nth(size_type i) const noexcept {
+    return static_cast<enum_type>(impl_type{1} << detail::select_bit_fast(
+      val_, static_cast<unsigned>(i)));
+  }
 
 
   constexpr iterator find(enum_type e) const noexcept { return {val_, e}; }
@@ -196,24 +285,76 @@ public:
   }
 
 
-  std::pair<iterator, iterator> equal_range(enum_type e) const noexcept {
-    auto i = find(e);
-    auto j = i;
-    return {i, ++j};
+  constexpr size_type count_in(flags mask) const noexcept {
+    return static_cast<size_type>(
+      detail::popcount(static_cast<impl_type>(val_ & mask.val_)));
+  }
+
+  constexpr bool any_of(flags mask) const noexcept {
+    return (val_ & mask.val_) != 0;
+  }
+
+  constexpr bool all_of(flags mask) const noexcept {
+    return (val_ & mask.val_) == mask.val_;
+  }
+
+  constexpr bool none_of(flags mask) const noexcept {
+    return (val_ & mask.val_) == 0;
+  }
+
+
+  // Set relations, each a single AND (or AND-NOT) and compare.
+  constexpr bool is_subset_of(flags fl) const noexcept {
+    return (val_ & ~fl.val_) == 0;
+  }
+
+  constexpr bool is_superset_of(flags fl) const noexcept {
+    return (fl.val_ & ~val_) == 0;
+  }
+
+  constexpr bool intersects(flags fl) const noexcept {
+    return (val_ & fl.val_) != 0;
+  }
+
+
+  // The first flag not below e, a single flag, and the first flag above e.
+  constexpr iterator lower_bound(enum_type e) const noexcept {
+    return {val_, static_cast<enum_type>(detail::lowest_bit(
+      static_cast<impl_type>(val_ & at_or_above(raw(e)))))};
+  }
+
+  constexpr iterator upper_bound(enum_type e) const noexcept {
+    return {val_, static_cast<enum_type>(detail::lowest_bit(
+      detail::bits_above(val_, raw(e))))};
+  }
+
+  constexpr std::pair<iterator, iterator>
+  equal_range(enum_type e) const noexcept {
+    return {lower_bound(e), upper_bound(e)};
+  }
+
+
+  // The flags below e, a single flag, and the flags from e on.
+  constexpr std::pair<flags, flags> split_at(enum_type e) const noexcept {
+    return {flags(static_cast<impl_type>(val_ & ~at_or_above(raw(e)))),
+            flags(static_cast<impl_type>(val_ & at_or_above(raw(e))))};
   }
 
 
   template <class... Args>
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   std::pair<iterator, bool> emplace(Args && ... args) noexcept {
     return insert(enum_type{args...});
   }
 
   template <class... Args>
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   iterator emplace_hint(iterator, Args && ... args) noexcept {
     return emplace(args...).first;
   }
 
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   std::pair<iterator, bool> insert(enum_type e) noexcept {
     auto i = find(e);
     if (i == end()) {
@@ -225,52 +366,78 @@ public:
     return {i, false};
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   std::pair<iterator, bool> insert(iterator, enum_type e) noexcept {
     return insert(e);
   }
 
   template <class FwIter>
-  auto insert(FwIter i1, FwIter i2)
+  ENUM_CLASS_FLAGS_CONSTEXPR14 auto insert(FwIter i1, FwIter i2)
   noexcept(noexcept(++i1) && noexcept(*i1) && noexcept(i1 == i2))
   -> typename convertible<decltype(*i1), void>::type {
-    val_ |= std::accumulate(i1, i2, impl_type{0}, [](impl_type i, enum_type e) {
-      return i | static_cast<impl_type>(e);
-    });
+    for (; i1 != i2; ++i1) { val_ |= static_cast<impl_type>(*i1); }
   }
 
   template <class Container>
-  auto insert(const Container &ctn) noexcept
+  ENUM_CLASS_FLAGS_CONSTEXPR14 auto insert(const Container &ctn) noexcept
   -> decltype(std::begin(ctn), std::end(ctn), void()) {
     insert(std::begin(ctn), std::end(ctn));
   }
 
 
-  iterator erase(iterator i) noexcept {
+  ENUM_CLASS_FLAGS_CONSTEXPR14 iterator erase(iterator i) noexcept {
     val_ ^= i.mask_;
     update_uvalue(i);
     return ++i;
   }
 
-  size_type erase(enum_type e) noexcept {
+  ENUM_CLASS_FLAGS_CONSTEXPR14 size_type erase(enum_type e) noexcept {
     auto e_count = count(e);
     val_ &= ~static_cast<impl_type>(e);
     return e_count;
   }
 
+  // One mask operation, whatever the length of the range.
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   iterator erase(iterator i1, iterator i2) noexcept {
-    val_ ^= flags(i1, i2).val_;
+    val_ &= static_cast<impl_type>(~range_mask(i1, i2));
     update_uvalue(i2);
     return i2;
   }
 
+  // Erases the flags of [i1, i2) and returns them.
+  ENUM_CLASS_FLAGS_CONSTEXPR14
+  flags extract_range(iterator i1, iterator i2) noexcept {
+    const flags extracted{range_mask(i1, i2)};
+    val_ ^= extracted.val_;
+    return extracted;
+  }
+
 
-  void clear() noexcept { val_ = 0; }
+  ENUM_CLASS_FLAGS_CONSTEXPR14 void clear() noexcept { val_ = 0; }
 
 private:
   constexpr explicit flags(impl_type val) noexcept : val_(val) {}
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14
   void update_uvalue(iterator &it) const noexcept { it.uvalue_ = val_; }
 
+  static constexpr impl_type raw(enum_type e) noexcept {
+    return static_cast<impl_type>(e);
+  }
+
+  // Bits at or above the single bit b (-b), or none if b is zero.
+  static constexpr impl_type at_or_above(impl_type b) noexcept {
+    return static_cast<impl_type>(~b + 1);
+  }
+
+  // Bits from the flag of i1 up to, not including, the flag of i2; an end
+  // iterator has no flag and i2 - 1 wraps to every bit above i1.
+  constexpr impl_type range_mask(iterator i1, iterator i2) const noexcept {
+    return static_cast<impl_type>(val_ & at_or_above(i1.mask_)
+                                  & static_cast<impl_type>(i2.mask_ - 1));
+  }
+
   impl_type val_;
 };
 
@@ -279,6 +446,17 @@ template <class E>
 void swap(flags<E> &fl1, flags<E> &fl2) noexcept { fl1.swap(fl2); }
 
 
+// Orders flags by their number of flags, then by value: sorting by
+// size_order lists the empty set, then every single flag, every pair, and
+// so on, still with every set before its strict supersets.
+struct size_order {
+  template <class E>
+  constexpr bool operator()(flags<E> fl1, flags<E> fl2) const noexcept {
+    return fl1.size() != fl2.size() ? fl1.size() < fl2.size() : fl1 < fl2;
+  }
+};
+
+
 } // namespace flags
 
 
@@ -306,4 +484,14 @@ constexpr auto operator^(E e1, E e2) noexcept
 }
 
 
+namespace std {
+template <class E> struct hash<flags::flags<E>> {
+  std::size_t operator()(flags::flags<E> fl) const noexcept {
+    return static_cast<std::size_t>(flags::detail::mix64(
+      static_cast<typename flags::flags<E>::impl_type>(fl.underlying_value())));
+  }
+};
+} // namespace std
+
+
 #endif // ENUM_CLASS_FLAGS_HPP
@@ -0,0 +1,182 @@
+#ifndef ENUM_CLASS_FLAGS_ACCUMULATOR_HPP
+#define ENUM_CLASS_FLAGS_ACCUMULATOR_HPP
+
+
+#include "atomic_flags.hpp"
+#include "flags.hpp"
+#include "memory.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+namespace flags {
+namespace detail {
+
+
+// The union and intersection reported by the threads of one slot, alone on
+// their cache line.
+template <class Impl> struct alignas(cache_line_size) accumulator_slot {
+  std::atomic<Impl> united{0};
+  std::atomic<Impl> intersected{0};
+};
+
+
+} // namespace detail
+
+
+// flags<E> reported to by many threads at once, read now and then: |= adds
+// to a union and &= narrows an intersection, both kept per thread and
+// combined on read. Thread i reports to slot i % slot_count() only, so
+// that threads up to slot_count() never write to the same cache line, and
+// reporting flags that the slot already has writes nothing at all.
+//
+// Reads see every report that happened before them, but not a single
+// instant of all threads: reports running concurrently with a read may be
+// seen in part.
+template <class E> class flags_accumulator {
+public:
+  using flags_type = flags<E>;
+  using underlying_type = typename flags_type::underlying_type;
+  using impl_type = typename flags_type::impl_type;
+
+  static_assert(detail::atomic_always_lock_free<sizeof(impl_type)>::value,
+                "flags::flags_accumulator requires lock-free atomics "
+                "of the enum's size");
+
+
+  // The reports between two calls to snapshot_and_reset(); epoch counts
+  // the snapshots taken so far, this one included.
+  struct snapshot {
+    flags_type united;
+    flags_type intersected;
+    std::uint64_t epoch;
+  };
+
+
+  // At least slots slots, rounded up to a power of two; one per hardware
+  // thread by default.
+  explicit flags_accumulator(std::size_t slots = default_slots())
+  : slots_(round_up(slots)), epoch_(0) {
+    for (auto &slot : slots_) {
+      slot.intersected.store(all(), std::memory_order_relaxed);
+    }
+  }
+
+  flags_accumulator(const flags_accumulator &) = delete;
+  flags_accumulator &operator=(const flags_accumulator &) = delete;
+
+
+  static std::size_t default_slots() noexcept {
+    const unsigned threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+  }
+
+  std::size_t slot_count() const noexcept { return slots_.size(); }
+
+
+  // Adds fl to the union.
+  flags_accumulator &operator|=(flags_type fl) noexcept {
+    auto &united = local().united;
+    const impl_type bits = raw(fl);
+    if ((united.load(std::memory_order_relaxed) & bits) != bits) {
+      united.fetch_or(bits, std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  // Drops every flag outside fl from the intersection.
+  flags_accumulator &operator&=(flags_type fl) noexcept {
+    auto &intersected = local().intersected;
+    const impl_type bits = raw(fl);
+    if ((intersected.load(std::memory_order_relaxed) & ~bits) != 0) {
+      intersected.fetch_and(bits, std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+
+  // The union of the flags added since the last reset.
+  flags_type united() const noexcept {
+    impl_type value = 0;
+    for (const auto &slot : slots_) {
+      value |= slot.united.load(std::memory_order_relaxed);
+    }
+    return to_flags(value);
+  }
+
+  // The intersection of the flags kept since the last reset, every valid
+  // flag when there were none.
+  flags_type intersected() const noexcept {
+    impl_type value = all();
+    for (const auto &slot : slots_) {
+      value &= slot.intersected.load(std::memory_order_relaxed);
+    }
+    return to_flags(value);
+  }
+
+
+  // Number of resets so far.
+  std::uint64_t epoch() const noexcept {
+    return epoch_.load(std::memory_order_relaxed);
+  }
+
+  // Takes the union and intersection of the reports since the last reset
+  // and starts over. Each slot is swapped for an empty one in one atomic
+  // exchange, so that a concurrent report ends up in exactly one of two
+  // consecutive snapshots.
+  snapshot snapshot_and_reset() noexcept {
+    impl_type united = 0;
+    impl_type intersected = all();
+    for (auto &slot : slots_) {
+      united |= slot.united.exchange(0, std::memory_order_relaxed);
+      intersected &= slot.intersected.exchange(all(),
+                                               std::memory_order_relaxed);
+    }
+    const std::uint64_t epoch =
+      epoch_.fetch_add(1, std::memory_order_relaxed) + 1;
+    return snapshot{to_flags(united), to_flags(intersected), epoch};
+  }
+
+
+private:
+  using slot_type = detail::accumulator_slot<impl_type>;
+
+
+  static std::size_t round_up(std::size_t slots) noexcept {
+    std::size_t size = 1;
+    while (size < slots) { size *= 2; }
+    return size;
+  }
+
+  static constexpr impl_type all() noexcept {
+    return static_cast<impl_type>(flags_type::all().underlying_value());
+  }
+
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  static flags_type to_flags(impl_type value) noexcept {
+    flags_type fl{empty_t{}};
+    fl.set_underlying_value(static_cast<underlying_type>(value));
+    return fl;
+  }
+
+  slot_type &local() noexcept {
+    return slots_[detail::thread_index() & (slots_.size() - 1)];
+  }
+
+
+  std::vector<slot_type, detail::aligned_allocator<slot_type>> slots_;
+  std::atomic<std::uint64_t> epoch_;
+};
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_FLAGS_ACCUMULATOR_HPP
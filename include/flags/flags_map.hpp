@@ -0,0 +1,679 @@
+#ifndef ENUM_CLASS_FLAGS_MAP_HPP
+#define ENUM_CLASS_FLAGS_MAP_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace flags {
+namespace detail {
+
+
+// Open addressing after Swiss tables. Slots come in groups of 16, each slot
+// with a control byte: 7 bits of the hash of its key when full, negative
+// when empty or deleted. A lookup compares the 16 control bytes of a group
+// with the hash of the key at once and only then looks at the slots; it
+// visits consecutive groups, starting at the one selected by the hash,
+// until one that has an empty slot. Slots live in one array with no
+// allocation per element.
+
+constexpr signed char ctrl_empty = -128;
+constexpr signed char ctrl_deleted = -2;
+constexpr std::size_t ctrl_group = 16;
+
+
+// Index of the first full slot at or after i, or capacity.
+inline std::size_t next_full(const signed char *ctrl, std::size_t i,
+                             std::size_t capacity) noexcept {
+  while (i < capacity) {
+    const std::size_t g = i / ctrl_group;
+    const unsigned full = ~find_negative16(ctrl + g * ctrl_group)
+                          & (0xffffu << (i % ctrl_group)) & 0xffffu;
+    if (full) {
+      return g * ctrl_group + static_cast<std::size_t>(countr_zero(full));
+    }
+    i = (g + 1) * ctrl_group;
+  }
+  return capacity;
+}
+
+
+// The table proper. Policy gives the slot type, how to get the raw key of a
+// slot and how to construct, move and destroy slots.
+template <class Policy> class hash_table {
+public:
+  using impl_type = typename Policy::impl_type;
+  using slot_type = typename Policy::slot_type;
+
+
+  hash_table() noexcept = default;
+
+  hash_table(const hash_table &other) {
+    if (!other.size_) { return; }
+    // built aside, so that the slots copied so far are destroyed if a copy
+    // throws
+    hash_table copy;
+    copy.allocate(other.groups_);
+    // same capacity, hence the same probe sequences: slots stay in place
+    for (std::size_t i = other.next(0); i != other.capacity();
+         i = other.next(i + 1)) {
+      Policy::copy(copy.slots_ + i, other.slots_[i]);
+      copy.ctrl_[i] = other.ctrl_[i];
+      ++copy.size_;
+    }
+    // and so do tombstones, without which lookups would stop at groups
+    // that were full when later keys were inserted past them
+    for (std::size_t i = 0; i < copy.capacity(); ++i) {
+      if (other.ctrl_[i] == ctrl_deleted) { copy.ctrl_[i] = ctrl_deleted; }
+    }
+    copy.deleted_ = other.deleted_;
+    swap(copy);
+  }
+
+  hash_table(hash_table &&other) noexcept { swap(other); }
+
+  // Not one noexcept assignment taking its argument by value: the implicit
+  // copy assignments of flags_map and flags_set would be noexcept too, and
+  // a value copy throwing in them would call std::terminate.
+  hash_table &operator=(const hash_table &other) {
+    hash_table copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  hash_table &operator=(hash_table &&other) noexcept {
+    hash_table moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  ~hash_table() {
+    clear();
+    deallocate();
+  }
+
+
+  std::size_t size() const noexcept { return size_; }
+  std::size_t capacity() const noexcept { return groups_ * ctrl_group; }
+
+  slot_type *slots() const noexcept { return slots_; }
+  const signed char *ctrl() const noexcept { return ctrl_; }
+
+  std::size_t next(std::size_t i) const noexcept {
+    return next_full(ctrl_, i, capacity());
+  }
+
+
+  // Index of the slot holding key, or capacity().
+  std::size_t find(impl_type key) const noexcept {
+    if (!groups_) { return 0; }
+    const std::uint64_t h = mix64(key);
+    const auto h2 = static_cast<signed char>(h & 0x7f);
+    for (std::size_t g = group_of(h);; g = (g + 1) & (groups_ - 1)) {
+      const signed char *group = ctrl_ + g * ctrl_group;
+      for (unsigned match = find_byte16(group, h2); match;
+           match = clear_lowest_bit(match)) {
+        const std::size_t i =
+          g * ctrl_group + static_cast<std::size_t>(countr_zero(match));
+        if (Policy::key(slots_[i]) == key) { return i; }
+      }
+      if (find_byte16(group, ctrl_empty)) { return capacity(); }
+    }
+  }
+
+  // Constructs a slot for key from args unless key is present. Returns the
+  // index of the slot holding key and whether it was inserted.
+  template <class... Args>
+  std::pair<std::size_t, bool> emplace(impl_type key, Args &&... args) {
+    std::size_t i = find(key);
+    if (i != capacity()) { return {i, false}; }
+
+    if (size_ + deleted_ >= max_load(groups_)) {
+      // tombstones are dropped by rehashing; grow only if that is not
+      // enough
+      rehash(deleted_ > size_ / 2 ? groups_ : (groups_ ? 2 * groups_ : 1));
+    }
+    const std::uint64_t h = mix64(key);
+    i = free_slot(h);
+    Policy::construct(slots_ + i, key, std::forward<Args>(args)...);
+    if (ctrl_[i] == ctrl_deleted) { --deleted_; }
+    ctrl_[i] = static_cast<signed char>(h & 0x7f);
+    ++size_;
+    return {i, true};
+  }
+
+  void erase_at(std::size_t i) noexcept {
+    Policy::destroy(slots_ + i);
+    --size_;
+    // no lookup has ever gone past a group that has an empty slot, so the
+    // slot can become empty rather than deleted
+    if (find_byte16(ctrl_ + i / ctrl_group * ctrl_group, ctrl_empty)) {
+      ctrl_[i] = ctrl_empty;
+    } else {
+      ctrl_[i] = ctrl_deleted;
+      ++deleted_;
+    }
+  }
+
+  void clear() noexcept {
+    for (std::size_t i = next(0); i != capacity(); i = next(i + 1)) {
+      Policy::destroy(slots_ + i);
+    }
+    for (std::size_t i = 0; i < capacity(); ++i) { ctrl_[i] = ctrl_empty; }
+    size_ = 0;
+    deleted_ = 0;
+  }
+
+  void reserve(std::size_t n) {
+    std::size_t groups = groups_ ? groups_ : 1;
+    while (max_load(groups) < n) { groups *= 2; }
+    if (groups != groups_) { rehash(groups); }
+  }
+
+  void swap(hash_table &other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(groups_, other.groups_);
+    std::swap(size_, other.size_);
+    std::swap(deleted_, other.deleted_);
+  }
+
+private:
+  // at most 7/8 of the slots are full or deleted
+  static constexpr std::size_t max_load(std::size_t groups) noexcept {
+    return groups * ctrl_group / 8 * 7;
+  }
+
+  std::size_t group_of(std::uint64_t h) const noexcept {
+    return static_cast<std::size_t>(h >> 7) & (groups_ - 1);
+  }
+
+  std::size_t free_slot(std::uint64_t h) const noexcept {
+    for (std::size_t g = group_of(h);; g = (g + 1) & (groups_ - 1)) {
+      if (const unsigned free = find_negative16(ctrl_ + g * ctrl_group)) {
+        return g * ctrl_group + static_cast<std::size_t>(countr_zero(free));
+      }
+    }
+  }
+
+
+  void allocate(std::size_t groups) {
+    const std::size_t n = groups * ctrl_group;
+    slot_type *slots = std::allocator<slot_type>().allocate(n);
+    try {
+      ctrl_ = std::allocator<signed char>().allocate(n);
+    } catch (...) {
+      std::allocator<slot_type>().deallocate(slots, n);
+      throw;
+    }
+    slots_ = slots;
+    for (std::size_t i = 0; i < n; ++i) { ctrl_[i] = ctrl_empty; }
+    groups_ = groups;
+  }
+
+  void deallocate() noexcept {
+    if (!groups_) { return; }
+    std::allocator<slot_type>().deallocate(slots_, capacity());
+    std::allocator<signed char>().deallocate(ctrl_, capacity());
+  }
+
+  void rehash(std::size_t groups) {
+    hash_table fresh;
+    fresh.allocate(groups);
+    for (std::size_t i = next(0); i != capacity(); i = next(i + 1)) {
+      const std::uint64_t h = mix64(Policy::key(slots_[i]));
+      const std::size_t j = fresh.free_slot(h);
+      Policy::transfer(fresh.slots_ + j, slots_ + i);
+      fresh.ctrl_[j] = static_cast<signed char>(h & 0x7f);
+      ctrl_[i] = ctrl_empty;
+    }
+    fresh.size_ = size_;
+    size_ = 0;
+    deleted_ = 0;
+    swap(fresh);
+  }
+
+
+  signed char *ctrl_ = nullptr;
+  slot_type *slots_ = nullptr;
+  std::size_t groups_ = 0;
+  std::size_t size_ = 0;
+  std::size_t deleted_ = 0;
+};
+
+
+template <class E, class V> struct map_policy {
+  using impl_type = typename flags<E>::impl_type;
+  using slot_type = std::pair<const flags<E>, V>;
+
+
+  static impl_type key(const slot_type &slot) noexcept {
+    return static_cast<impl_type>(slot.first.underlying_value());
+  }
+
+  template <class... Args>
+  static void construct(slot_type *p, impl_type key, Args &&... args) {
+    flags<E> fl{empty_t{}};
+    fl.set_underlying_value(
+      static_cast<typename flags<E>::underlying_type>(key));
+    ::new (static_cast<void *>(p))
+      slot_type(std::piecewise_construct, std::forward_as_tuple(fl),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  static void copy(slot_type *p, const slot_type &slot) {
+    ::new (static_cast<void *>(p)) slot_type(slot);
+  }
+
+  static void transfer(slot_type *dst, slot_type *src) {
+    ::new (static_cast<void *>(dst)) slot_type(std::move(*src));
+    src->~slot_type();
+  }
+
+  static void destroy(slot_type *p) noexcept { p->~slot_type(); }
+};
+
+
+template <class E> struct set_policy {
+  using impl_type = typename flags<E>::impl_type;
+  using slot_type = impl_type;
+
+
+  static impl_type key(slot_type slot) noexcept { return slot; }
+
+  static void construct(slot_type *p, impl_type key) noexcept { *p = key; }
+  static void copy(slot_type *p, slot_type slot) noexcept { *p = slot; }
+  static void transfer(slot_type *dst, slot_type *src) noexcept {
+    *dst = *src;
+  }
+  static void destroy(slot_type *) noexcept {}
+};
+
+
+} // namespace detail
+
+
+template <class E, class V> class flags_map;
+template <class E> class flags_set;
+
+
+template <class E, class V, bool Const>
+class FlagsMapIterator {
+public:
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::pair<const flags<E>, V>;
+  using pointer = typename std::conditional<Const, const value_type *,
+                                            value_type *>::type;
+  using reference = typename std::conditional<Const, const value_type &,
+                                              value_type &>::type;
+  using iterator_category = std::forward_iterator_tag;
+
+
+  FlagsMapIterator() noexcept = default;
+
+  // iterator to const_iterator
+  template <bool C = Const, class = typename std::enable_if<C>::type>
+  FlagsMapIterator(const FlagsMapIterator<E, V, false> &i) noexcept
+  : slots_(i.slots_), ctrl_(i.ctrl_), i_(i.i_), capacity_(i.capacity_) {}
+
+
+  reference operator*() const noexcept { return slots_[i_]; }
+  pointer operator->() const noexcept { return slots_ + i_; }
+
+  FlagsMapIterator &operator++() noexcept {
+    i_ = detail::next_full(ctrl_, i_ + 1, capacity_);
+    return *this;
+  }
+  FlagsMapIterator operator++(int) noexcept {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+
+  friend bool operator==(const FlagsMapIterator &i,
+                         const FlagsMapIterator &j) noexcept {
+    return i.i_ == j.i_ && i.slots_ == j.slots_;
+  }
+  friend bool operator!=(const FlagsMapIterator &i,
+                         const FlagsMapIterator &j) noexcept {
+    return !(i == j);
+  }
+
+private:
+  template <class E_, class V_> friend class flags_map;
+  template <class E_, class V_, bool C_> friend class FlagsMapIterator;
+
+
+  FlagsMapIterator(pointer slots, const signed char *ctrl, std::size_t i,
+                   std::size_t capacity) noexcept
+  : slots_(slots), ctrl_(ctrl), i_(i), capacity_(capacity) {}
+
+
+  pointer slots_ = nullptr;
+  const signed char *ctrl_ = nullptr;
+  std::size_t i_ = 0;
+  std::size_t capacity_ = 0;
+};
+
+
+// An unordered map from flags<E> to V. Lookups hash the raw value with
+// mix64 and probe with vector compares of control bytes (see
+// detail::hash_table); elements are stored inline in one array, so that
+// inserting allocates only when the table grows.
+//
+// Like std::unordered_map, except that inserting or erasing invalidates
+// all iterators, and inserting may move elements, invalidating references
+// to them as well.
+template <class E, class V> class flags_map {
+  using table_type = detail::hash_table<detail::map_policy<E, V>>;
+
+public:
+  using key_type = flags<E>;
+  using mapped_type = V;
+  using value_type = std::pair<const key_type, V>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using iterator = FlagsMapIterator<E, V, false>;
+  using const_iterator = FlagsMapIterator<E, V, true>;
+
+
+  flags_map() noexcept = default;
+
+  explicit flags_map(size_type n) { reserve(n); }
+
+  flags_map(std::initializer_list<value_type> il) {
+    reserve(il.size());
+    for (const auto &value : il) { insert(value); }
+  }
+
+
+  bool empty() const noexcept { return !size(); }
+  size_type size() const noexcept { return table_.size(); }
+  size_type capacity() const noexcept { return table_.capacity(); }
+
+  // Makes room for n elements without growing.
+  void reserve(size_type n) { table_.reserve(n); }
+  void clear() noexcept { table_.clear(); }
+
+
+  iterator begin() noexcept { return make_iterator(table_.next(0)); }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator cbegin() const noexcept {
+    return make_iterator(table_.next(0));
+  }
+
+  iterator end() noexcept { return make_iterator(capacity()); }
+  const_iterator end() const noexcept { return cend(); }
+  const_iterator cend() const noexcept { return make_iterator(capacity()); }
+
+
+  iterator find(key_type key) noexcept {
+    return make_iterator(table_.find(raw(key)));
+  }
+  const_iterator find(key_type key) const noexcept {
+    return make_iterator(table_.find(raw(key)));
+  }
+
+  size_type count(key_type key) const noexcept { return contains(key); }
+  bool contains(key_type key) const noexcept {
+    return table_.find(raw(key)) != capacity();
+  }
+
+
+  // Constructs the value for key from args, unless key is present.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(key_type key, Args &&... args) {
+    const auto r = table_.emplace(raw(key), std::forward<Args>(args)...);
+    return {make_iterator(r.first), r.second};
+  }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type &&value) {
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  template <class M>
+  std::pair<iterator, bool> insert_or_assign(key_type key, M &&m) {
+    auto r = try_emplace(key, std::forward<M>(m));
+    if (!r.second) { r.first->second = std::forward<M>(m); }
+    return r;
+  }
+
+  V &operator[](key_type key) { return try_emplace(key).first->second; }
+
+
+  size_type erase(key_type key) noexcept {
+    const std::size_t i = table_.find(raw(key));
+    if (i == capacity()) { return 0; }
+    table_.erase_at(i);
+    return 1;
+  }
+
+  // Returns the iterator following i.
+  iterator erase(const_iterator i) noexcept {
+    table_.erase_at(i.i_);
+    return make_iterator(table_.next(i.i_ + 1));
+  }
+
+
+  void swap(flags_map &other) noexcept { table_.swap(other.table_); }
+
+  friend bool operator==(const flags_map &m1, const flags_map &m2) {
+    if (m1.size() != m2.size()) { return false; }
+    for (const auto &value : m1) {
+      const auto i = m2.find(value.first);
+      if (i == m2.end() || !(i->second == value.second)) { return false; }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const flags_map &m1, const flags_map &m2) {
+    return !(m1 == m2);
+  }
+
+private:
+  using impl_type = typename key_type::impl_type;
+
+  static impl_type raw(key_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  iterator make_iterator(std::size_t i) noexcept {
+    return {table_.slots(), table_.ctrl(), i, capacity()};
+  }
+  const_iterator make_iterator(std::size_t i) const noexcept {
+    return {table_.slots(), table_.ctrl(), i, capacity()};
+  }
+
+
+  table_type table_;
+};
+
+
+template <class E, class V>
+void swap(flags_map<E, V> &m1, flags_map<E, V> &m2) noexcept { m1.swap(m2); }
+
+
+template <class E>
+class FlagsSetIterator {
+public:
+  using flags_type = flags<E>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = flags_type;
+  using pointer = const value_type *;
+  using reference = const value_type;
+  using iterator_category = std::forward_iterator_tag;
+
+
+  FlagsSetIterator() noexcept = default;
+
+
+  reference operator*() const noexcept {
+    flags_type fl{empty_t{}};
+    fl.set_underlying_value(
+      static_cast<typename flags_type::underlying_type>(slots_[i_]));
+    return fl;
+  }
+
+  FlagsSetIterator &operator++() noexcept {
+    i_ = detail::next_full(ctrl_, i_ + 1, capacity_);
+    return *this;
+  }
+  FlagsSetIterator operator++(int) noexcept {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+
+  friend bool operator==(const FlagsSetIterator &i,
+                         const FlagsSetIterator &j) noexcept {
+    return i.i_ == j.i_ && i.slots_ == j.slots_;
+  }
+  friend bool operator!=(const FlagsSetIterator &i,
+                         const FlagsSetIterator &j) noexcept {
+    return !(i == j);
+  }
+
+private:
+  template <class E_> friend class flags_set;
+
+  using impl_type = typename flags_type::impl_type;
+
+
+  FlagsSetIterator(const impl_type *slots, const signed char *ctrl,
+                   std::size_t i, std::size_t capacity) noexcept
+  : slots_(slots), ctrl_(ctrl), i_(i), capacity_(capacity) {}
+
+
+  const impl_type *slots_ = nullptr;
+  const signed char *ctrl_ = nullptr;
+  std::size_t i_ = 0;
+  std::size_t capacity_ = 0;
+};
+
+
+// An unordered set of flags<E> values, stored as raw impl_type values in a
+// detail::hash_table. Inserting or erasing invalidates iterators.
+template <class E> class flags_set {
+  using table_type = detail::hash_table<detail::set_policy<E>>;
+
+public:
+  using key_type = flags<E>;
+  using value_type = key_type;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator = FlagsSetIterator<E>;
+  using const_iterator = iterator;
+  using reference = typename iterator::reference;
+  using const_reference = reference;
+
+
+  flags_set() noexcept = default;
+
+  explicit flags_set(size_type n) { reserve(n); }
+
+  flags_set(std::initializer_list<value_type> il) {
+    reserve(il.size());
+    for (auto fl : il) { insert(fl); }
+  }
+
+
+  bool empty() const noexcept { return !size(); }
+  size_type size() const noexcept { return table_.size(); }
+  size_type capacity() const noexcept { return table_.capacity(); }
+
+  void reserve(size_type n) { table_.reserve(n); }
+  void clear() noexcept { table_.clear(); }
+
+
+  iterator begin() const noexcept { return make_iterator(table_.next(0)); }
+  iterator cbegin() const noexcept { return begin(); }
+  iterator end() const noexcept { return make_iterator(capacity()); }
+  iterator cend() const noexcept { return end(); }
+
+
+  iterator find(value_type fl) const noexcept {
+    return make_iterator(table_.find(raw(fl)));
+  }
+
+  size_type count(value_type fl) const noexcept { return contains(fl); }
+  bool contains(value_type fl) const noexcept {
+    return table_.find(raw(fl)) != capacity();
+  }
+
+
+  std::pair<iterator, bool> insert(value_type fl) {
+    const auto r = table_.emplace(raw(fl));
+    return {make_iterator(r.first), r.second};
+  }
+
+  size_type erase(value_type fl) noexcept {
+    const std::size_t i = table_.find(raw(fl));
+    if (i == capacity()) { return 0; }
+    table_.erase_at(i);
+    return 1;
+  }
+
+  iterator erase(iterator i) noexcept {
+    table_.erase_at(i.i_);
+    return make_iterator(table_.next(i.i_ + 1));
+  }
+
+
+  void swap(flags_set &other) noexcept { table_.swap(other.table_); }
+
+  friend bool operator==(const flags_set &s1, const flags_set &s2) noexcept {
+    if (s1.size() != s2.size()) { return false; }
+    for (auto fl : s1) {
+      if (!s2.contains(fl)) { return false; }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const flags_set &s1, const flags_set &s2) noexcept {
+    return !(s1 == s2);
+  }
+
+private:
+  using impl_type = typename key_type::impl_type;
+
+  static impl_type raw(value_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  iterator make_iterator(std::size_t i) const noexcept {
+    return {table_.slots(), table_.ctrl(), i, capacity()};
+  }
+
+
+  table_type table_;
+};
+
+
+template <class E>
+void swap(flags_set<E> &s1, flags_set<E> &s2) noexcept { s1.swap(s2); }
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_FLAGS_MAP_HPP
@@ -0,0 +1,180 @@
+#ifndef ENUM_CLASS_FLAGS_TABLE_HPP
+#define ENUM_CLASS_FLAGS_TABLE_HPP
+
+
+#include "allow_flags.hpp"
+#include "bits.hpp"
+#include "flags.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+
+#ifndef ENUM_CLASS_FLAGS_TABLE_MAX_BITS
+#  define ENUM_CLASS_FLAGS_TABLE_MAX_BITS 16
+#endif
+
+
+namespace flags {
+namespace detail {
+
+
+template <std::size_t ... I> struct index_sequence {};
+
+template <class S1, class S2> struct concat_sequence;
+
+template <std::size_t ... I, std::size_t ... J>
+struct concat_sequence<index_sequence<I...>, index_sequence<J...>> {
+  using type = index_sequence<I..., (sizeof...(I) + J)...>;
+};
+
+// Halving instead of counting down keeps the instantiation depth at
+// log2(N), so that tables of a few thousand entries still compile.
+template <std::size_t N> struct make_index_sequence_impl
+: concat_sequence<typename make_index_sequence_impl<N / 2>::type,
+                  typename make_index_sequence_impl<N - N / 2>::type> {};
+
+template <> struct make_index_sequence_impl<0> {
+  using type = index_sequence<>;
+};
+
+template <> struct make_index_sequence_impl<1> {
+  using type = index_sequence<0>;
+};
+
+template <std::size_t N>
+using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+
+} // namespace detail
+
+
+// A value for every combination of the valid flags of E (see
+// ALLOW_FLAGS_FOR_ENUM_VALUES), in one array of 2^k entries for k valid
+// flags. The valid bits need not be contiguous: a key is mapped to its
+// index by packing its valid bits together (pext where the target has
+// BMI2), so an enum of bits 0, 4, 9 and 30 gets a 16-entry table. Bits of a
+// key outside the valid ones are ignored.
+template <class E, class V> class flags_table {
+public:
+  using flags_type = flags<E>;
+  using impl_type = typename flags_type::impl_type;
+  using value_type = V;
+  using size_type = std::size_t;
+  using reference = V &;
+  using const_reference = const V &;
+  using iterator = V *;
+  using const_iterator = const V *;
+
+  static constexpr impl_type mask = enum_mask<E>::value;
+  static constexpr std::size_t key_bits =
+    static_cast<std::size_t>(detail::popcount(mask));
+
+  static_assert(key_bits <= ENUM_CLASS_FLAGS_TABLE_MAX_BITS,
+                "flags::flags_table needs few valid flags; "
+                "use ALLOW_FLAGS_FOR_ENUM_VALUES macro.");
+
+
+private:
+  static constexpr unsigned shift =
+    mask ? static_cast<unsigned>(detail::countr_zero(mask)) : 0u;
+  // the valid bits are one run, so that an index is a shift away
+  static constexpr bool contiguous =
+    (((mask >> shift) + 1) & (mask >> shift)) == 0;
+
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+
+public:
+  static constexpr size_type size() noexcept {
+    return size_type{1} << key_bits;
+  }
+
+  // Index of the entry for fl.
+  static constexpr size_type index(flags_type fl) noexcept {
+    return contiguous ? (raw(fl) & mask) >> shift
+                      : detail::extract_bits(raw(fl), mask);
+  }
+
+  // Key of the entry at index i.
+  static constexpr flags_type key(size_type i) noexcept {
+    return flags_type(static_cast<E>(
+      detail::deposit_bits(static_cast<impl_type>(i), mask)));
+  }
+
+
+  constexpr flags_table() noexcept(noexcept(V())) : values_{} {}
+
+  explicit flags_table(const V &value)
+  noexcept(std::is_nothrow_copy_assignable<V>::value)
+  { fill(value); }
+
+  // The table whose entry for fl is gen(fl), at compile time when gen is
+  // a constant expression.
+  template <class Gen>
+  static constexpr flags_table generate(Gen gen) {
+    return flags_table(gen, detail::make_index_sequence<(1u << key_bits)>{});
+  }
+
+
+  V &operator[](flags_type fl) noexcept { return values_[fast_index(fl)]; }
+
+  const V &operator[](flags_type fl) const noexcept {
+    return values_[fast_index(fl)];
+  }
+
+  // operator[] for constant expressions.
+  constexpr const V &lookup(flags_type fl) const noexcept {
+    return values_[index(fl)];
+  }
+
+
+  V *data() noexcept { return values_; }
+  constexpr const V *data() const noexcept { return values_; }
+
+  iterator begin() noexcept { return values_; }
+  iterator end() noexcept { return values_ + size(); }
+  constexpr const_iterator begin() const noexcept { return values_; }
+  constexpr const_iterator end() const noexcept { return values_ + size(); }
+  constexpr const_iterator cbegin() const noexcept { return begin(); }
+  constexpr const_iterator cend() const noexcept { return end(); }
+
+  void fill(const V &value)
+  noexcept(std::is_nothrow_copy_assignable<V>::value) {
+    for (auto &v : values_) { v = value; }
+  }
+
+
+private:
+  template <class Gen, std::size_t ... I>
+  constexpr flags_table(Gen &gen, detail::index_sequence<I...>)
+  : values_{gen(key(I))...} {}
+
+  static size_type fast_index(flags_type fl) noexcept {
+    return contiguous ? (raw(fl) & mask) >> shift
+                      : detail::extract_bits_fast(raw(fl), mask);
+  }
+
+
+  V values_[size_type{1} << key_bits];
+};
+
+
+template <class E, class V>
+constexpr typename flags_table<E, V>::impl_type flags_table<E, V>::mask;
+
+template <class E, class V>
+constexpr std::size_t flags_table<E, V>::key_bits;
+
+template <class E, class V>
+constexpr unsigned flags_table<E, V>::shift;
+
+template <class E, class V>
+constexpr bool flags_table<E, V>::contiguous;
+
+
+} // namespace flags
+
+#endif // ENUM_CLASS_FLAGS_TABLE_HPP
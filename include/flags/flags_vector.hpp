@@ -0,0 +1,290 @@
+#ifndef ENUM_CLASS_FLAGS_VECTOR_HPP
+#define ENUM_CLASS_FLAGS_VECTOR_HPP
+
+
+#include "flags.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+
+namespace flags {
+
+
+template <class E> class flags_vector;
+
+
+template <class E>
+class FlagsVectorIterator {
+public:
+  using flags_type = flags<E>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = flags_type;
+  using pointer = const value_type *;
+  using reference = const value_type;
+  using iterator_category = std::random_access_iterator_tag;
+
+
+  constexpr FlagsVectorIterator() noexcept : ptr_(nullptr) {}
+
+
+  FlagsVectorIterator &operator++() noexcept {
+    ++ptr_;
+    return *this;
+  }
+  FlagsVectorIterator operator++(int) noexcept {
+    auto copy = *this;
+    ++ptr_;
+    return copy;
+  }
+
+  FlagsVectorIterator &operator--() noexcept {
+    --ptr_;
+    return *this;
+  }
+  FlagsVectorIterator operator--(int) noexcept {
+    auto copy = *this;
+    --ptr_;
+    return copy;
+  }
+
+  FlagsVectorIterator &operator+=(difference_type n) noexcept {
+    ptr_ += n;
+    return *this;
+  }
+  FlagsVectorIterator &operator-=(difference_type n) noexcept {
+    ptr_ -= n;
+    return *this;
+  }
+
+  friend FlagsVectorIterator operator+(FlagsVectorIterator i,
+                                       difference_type n) noexcept {
+    return i += n;
+  }
+  friend FlagsVectorIterator operator+(difference_type n,
+                                       FlagsVectorIterator i) noexcept {
+    return i += n;
+  }
+  friend FlagsVectorIterator operator-(FlagsVectorIterator i,
+                                       difference_type n) noexcept {
+    return i -= n;
+  }
+  friend difference_type operator-(const FlagsVectorIterator &i,
+                                   const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ - j.ptr_;
+  }
+
+
+  reference operator*() const noexcept { return to_flags(*ptr_); }
+
+  reference operator[](difference_type n) const noexcept {
+    return to_flags(ptr_[n]);
+  }
+
+
+  friend bool operator==(const FlagsVectorIterator &i,
+                         const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ == j.ptr_;
+  }
+  friend bool operator!=(const FlagsVectorIterator &i,
+                         const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ != j.ptr_;
+  }
+  friend bool operator<(const FlagsVectorIterator &i,
+                        const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ < j.ptr_;
+  }
+  friend bool operator>(const FlagsVectorIterator &i,
+                        const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ > j.ptr_;
+  }
+  friend bool operator<=(const FlagsVectorIterator &i,
+                         const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ <= j.ptr_;
+  }
+  friend bool operator>=(const FlagsVectorIterator &i,
+                         const FlagsVectorIterator &j) noexcept {
+    return i.ptr_ >= j.ptr_;
+  }
+
+
+private:
+  template <class E_> friend class flags_vector;
+
+  using impl_type = typename flags_type::impl_type;
+
+
+  explicit FlagsVectorIterator(const impl_type *ptr) noexcept : ptr_(ptr) {}
+
+  static flags_type to_flags(impl_type value) noexcept {
+    flags_type fl{empty};
+    fl.set_underlying_value(
+      static_cast<typename flags_type::underlying_type>(value));
+    return fl;
+  }
+
+
+  const impl_type *ptr_;
+};
+
+
+// A column of flags<E> values. The raw impl_type values are stored
+// contiguously on cache-line-aligned storage, and bulk operations over the
+// whole column run as vectorized kernels. Elements are read as flags<E>
+// values and written with set().
+template <class E> class flags_vector {
+public:
+  using flags_type = flags<E>;
+  using enum_type = typename flags_type::enum_type;
+  using impl_type = typename flags_type::impl_type;
+
+  using iterator = FlagsVectorIterator<enum_type>;
+  using const_iterator = iterator;
+  using value_type = flags_type;
+  using reference = typename iterator::reference;
+  using const_reference = reference;
+  using size_type = std::size_t;
+  using difference_type = typename iterator::difference_type;
+
+
+  flags_vector() noexcept = default;
+
+  explicit flags_vector(size_type n, flags_type fl = flags_type{empty_t{}})
+  : values_(n, raw(fl)) {}
+
+  flags_vector(std::initializer_list<flags_type> il)
+  : flags_vector(il.begin(), il.end()) {}
+
+  template <class InIter>
+  flags_vector(InIter b, InIter e,
+               typename std::enable_if<
+                 std::is_convertible<decltype(*b), flags_type>::value,
+                 std::nullptr_t>::type = nullptr) {
+    for (; b != e; ++b) { push_back(*b); }
+  }
+
+
+  bool empty() const noexcept { return values_.empty(); }
+  size_type size() const noexcept { return values_.size(); }
+  size_type capacity() const noexcept { return values_.capacity(); }
+
+  void reserve(size_type n) { values_.reserve(n); }
+  void resize(size_type n, flags_type fl = flags_type{empty_t{}}) {
+    values_.resize(n, raw(fl));
+  }
+  void shrink_to_fit() { values_.shrink_to_fit(); }
+  void clear() noexcept { values_.clear(); }
+
+  void push_back(flags_type fl) { values_.push_back(raw(fl)); }
+  void pop_back() noexcept { values_.pop_back(); }
+
+
+  reference operator[](size_type i) const noexcept { return begin()[i]; }
+  reference front() const noexcept { return *begin(); }
+  reference back() const noexcept { return *(end() - 1); }
+
+  void set(size_type i, flags_type fl) noexcept { values_[i] = raw(fl); }
+
+
+  impl_type *data() noexcept { return values_.data(); }
+  const impl_type *data() const noexcept { return values_.data(); }
+
+
+  iterator begin() const noexcept { return cbegin(); }
+  iterator cbegin() const noexcept { return iterator{values_.data()}; }
+
+  iterator end() const noexcept { return cend(); }
+  iterator cend() const noexcept {
+    return iterator{values_.data() + values_.size()};
+  }
+
+
+  // Element-wise bitwise operations with one mask for the whole column.
+  flags_vector &operator|=(flags_type mask) noexcept {
+    detail::transform_broadcast<detail::or_op>(data(), size(), raw(mask));
+    return *this;
+  }
+
+  flags_vector &operator&=(flags_type mask) noexcept {
+    detail::transform_broadcast<detail::and_op>(data(), size(), raw(mask));
+    return *this;
+  }
+
+  flags_vector &operator^=(flags_type mask) noexcept {
+    detail::transform_broadcast<detail::xor_op>(data(), size(), raw(mask));
+    return *this;
+  }
+
+
+  // Element-wise bitwise operations with another column. Only the first
+  // min(size(), other.size()) elements are affected.
+  flags_vector &operator|=(const flags_vector &other) noexcept {
+    detail::transform_elements<detail::or_op>(data(), other.data(),
+                                              common_size(other));
+    return *this;
+  }
+
+  flags_vector &operator&=(const flags_vector &other) noexcept {
+    detail::transform_elements<detail::and_op>(data(), other.data(),
+                                               common_size(other));
+    return *this;
+  }
+
+  flags_vector &operator^=(const flags_vector &other) noexcept {
+    detail::transform_elements<detail::xor_op>(data(), other.data(),
+                                               common_size(other));
+    return *this;
+  }
+
+
+  // Number of elements that contain every flag of mask.
+  size_type count_matching(flags_type mask) const noexcept {
+    return detail::count_superset(data(), size(), raw(mask));
+  }
+
+  // Whether some element contains every flag of mask.
+  bool any_matching(flags_type mask) const noexcept {
+    return detail::find_superset(data(), size(), raw(mask)) != size();
+  }
+
+  // Writes the size() of every element to out[0], ..., out[size() - 1].
+  void sizes(unsigned char *out) const noexcept {
+    detail::popcount_elements(data(), size(), out);
+  }
+
+
+  void swap(flags_vector &other) noexcept { values_.swap(other.values_); }
+
+  friend bool operator==(const flags_vector &v1, const flags_vector &v2) {
+    return v1.values_ == v2.values_;
+  }
+
+  friend bool operator!=(const flags_vector &v1, const flags_vector &v2) {
+    return v1.values_ != v2.values_;
+  }
+
+private:
+  static impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+  size_type common_size(const flags_vector &other) const noexcept {
+    return size() < other.size() ? size() : other.size();
+  }
+
+  std::vector<impl_type, detail::aligned_allocator<impl_type>> values_;
+};
+
+
+template <class E>
+void swap(flags_vector<E> &v1, flags_vector<E> &v2) noexcept { v1.swap(v2); }
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_FLAGS_VECTOR_HPP
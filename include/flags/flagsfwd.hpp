@@ -2,6 +2,17 @@
 #define ENUM_CLASS_FLAGSFWD_HPP
 
 
+// Marks functions that mutate their object, which can only be constexpr
+// with the relaxed constexpr rules of C++14.
+#if (defined(__cpp_constexpr) && __cpp_constexpr >= 201304L) \
+    || (defined(_MSC_VER) && _MSC_VER >= 1910 && _MSVC_LANG >= 201402L)
+#  define ENUM_CLASS_FLAGS_HAS_CONSTEXPR14
+#  define ENUM_CLASS_FLAGS_CONSTEXPR14 constexpr
+#else
+#  define ENUM_CLASS_FLAGS_CONSTEXPR14
+#endif
+
+
 namespace flags { template <class E> class flags; }
 
 
@@ -0,0 +1,260 @@
+#ifndef ENUM_CLASS_HISTOGRAM_HPP
+#define ENUM_CLASS_HISTOGRAM_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+#include "flags_vector.hpp"
+#include "simd.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace flags {
+namespace detail {
+
+
+// A 64-bit word standing in for a vector where SSE2 is not available.
+struct word_isa {
+  using vector = std::uint64_t;
+  static constexpr std::size_t bytes = 8;
+
+  static vector load(const void *p) noexcept {
+    vector v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static void store(void *p, vector v) noexcept {
+    std::memcpy(p, &v, sizeof(v));
+  }
+  static vector broadcast(std::uint64_t x) noexcept { return x; }
+};
+
+#if defined(ENUM_CLASS_FLAGS_HAS_AVX2) || defined(ENUM_CLASS_FLAGS_HAS_SSE2)
+using histogram_isa = native_isa;
+#else
+using histogram_isa = word_isa;
+#endif
+
+
+// Carry-save adder: h:l = a + b + c, bit by bit.
+template <class V>
+void carry_save(V &h, V &l, V a, V b, V c) noexcept {
+  const V u = xor_op::apply(a, b);
+  h = or_op::apply(and_op::apply(a, b), and_op::apply(u, c));
+  l = xor_op::apply(u, c);
+}
+
+
+// Per-bit counts of impl_type values, after Harley and Seal: every block of
+// 16 vectors is reduced with carry-save adders to bit-sliced ones, twos,
+// fours and eights, which carry into one sixteens vector per block. The
+// sixteens are added to a bit-sliced counter of levels bits, and only that
+// counter is split into per-bit counts, once every 2^levels - 1 blocks.
+// The work per vector is a few bitwise operations whatever the width of
+// impl_type.
+template <class Impl, class Isa> class bit_slice_counter {
+public:
+  using vector = typename Isa::vector;
+
+  static constexpr std::size_t lanes = Isa::bytes / sizeof(Impl);
+  static constexpr std::size_t block = 16 * lanes;
+  static constexpr unsigned levels = 8;
+
+
+  explicit bit_slice_counter(std::uint64_t *counts) noexcept
+  : counts_(counts), blocks_(0) {
+    ones_ = twos_ = fours_ = eights_ = zero();
+    for (auto &level : levels_) { level = zero(); }
+  }
+
+  // Counts n / block blocks of src and returns the number of values read.
+  std::size_t add(const Impl *src, std::size_t n) noexcept {
+    std::size_t i = 0;
+    for (; i + block <= n; i += block) {
+      add_block(src + i);
+      // a level holds at most 2^levels - 1 sixteens
+      if (++blocks_ == (std::size_t{1} << levels) - 1) {
+        flush_levels();
+        blocks_ = 0;
+      }
+    }
+    return i;
+  }
+
+  // Adds what is still bit-sliced to the counts.
+  void flush() noexcept {
+    flush_levels();
+    split(ones_, 0);
+    split(twos_, 1);
+    split(fours_, 2);
+    split(eights_, 3);
+    ones_ = twos_ = fours_ = eights_ = zero();
+  }
+
+
+private:
+  static vector zero() noexcept { return Isa::broadcast(std::uint64_t{0}); }
+
+  vector load(const Impl *p, std::size_t k) const noexcept {
+    return Isa::load(p + k * lanes);
+  }
+
+  void add_block(const Impl *p) noexcept {
+    vector twos_a, twos_b, fours_a, fours_b, eights_a, eights_b, sixteens;
+    carry_save(twos_a, ones_, ones_, load(p, 0), load(p, 1));
+    carry_save(twos_b, ones_, ones_, load(p, 2), load(p, 3));
+    carry_save(fours_a, twos_, twos_, twos_a, twos_b);
+    carry_save(twos_a, ones_, ones_, load(p, 4), load(p, 5));
+    carry_save(twos_b, ones_, ones_, load(p, 6), load(p, 7));
+    carry_save(fours_b, twos_, twos_, twos_a, twos_b);
+    carry_save(eights_a, fours_, fours_, fours_a, fours_b);
+    carry_save(twos_a, ones_, ones_, load(p, 8), load(p, 9));
+    carry_save(twos_b, ones_, ones_, load(p, 10), load(p, 11));
+    carry_save(fours_a, twos_, twos_, twos_a, twos_b);
+    carry_save(twos_a, ones_, ones_, load(p, 12), load(p, 13));
+    carry_save(twos_b, ones_, ones_, load(p, 14), load(p, 15));
+    carry_save(fours_b, twos_, twos_, twos_a, twos_b);
+    carry_save(eights_b, fours_, fours_, fours_a, fours_b);
+    carry_save(sixteens, eights_, eights_, eights_a, eights_b);
+
+    // ripple the sixteens into the counter
+    vector carry = sixteens;
+    for (auto &level : levels_) {
+      const vector next = and_op::apply(level, carry);
+      level = xor_op::apply(level, carry);
+      carry = next;
+    }
+  }
+
+  // counts[b] += (number of lanes with bit b set in v) << shift
+  void split(vector v, unsigned shift) noexcept {
+    Impl values[lanes];
+    Isa::store(values, v);
+    for (auto value : values) {
+      for (std::size_t b = 0; b < sizeof(Impl) * 8; ++b) {
+        counts_[b] += static_cast<std::uint64_t>((value >> b) & 1u) << shift;
+      }
+    }
+  }
+
+  void flush_levels() noexcept {
+    for (unsigned d = 0; d < levels; ++d) {
+      split(levels_[d], 4 + d);
+      levels_[d] = zero();
+    }
+  }
+
+
+  std::uint64_t *counts_;
+  std::size_t blocks_;
+  vector ones_, twos_, fours_, eights_;
+  vector levels_[levels];
+};
+
+
+} // namespace detail
+
+
+// Counts how many values have each flag set, over a stream of flags<E>
+// values fed in chunks. Each add() has a fixed cost of a few thousand
+// operations besides the work per value, so chunks should hold thousands
+// of values.
+template <class E> class flag_counter {
+public:
+  using flags_type = flags<E>;
+  using impl_type = typename flags_type::impl_type;
+  using counts_type = std::array<std::uint64_t, flags_type::bit_size()>;
+
+
+  flag_counter() noexcept : counts_{}, total_(0) {}
+
+
+  void add(const flags_type *values, std::size_t n) noexcept {
+    static_assert(sizeof(flags_type) == sizeof(impl_type),
+                  "flags<E> must have the layout of impl_type");
+    add_raw(reinterpret_cast<const impl_type *>(values), n);
+  }
+
+  void add(const flags_vector<E> &column) noexcept {
+    add_raw(column.data(), column.size());
+  }
+
+  void add(flags_type fl) noexcept {
+    const auto value = static_cast<impl_type>(fl.underlying_value());
+    for (std::size_t b = 0; b < flags_type::bit_size(); ++b) {
+      counts_[b] += (value >> b) & 1u;
+    }
+    ++total_;
+  }
+
+
+  // Number of values counted so far with flag e, a single flag, set; 0
+  // for no flag at all.
+  std::uint64_t count(E e) const noexcept {
+    const auto bit = static_cast<impl_type>(e);
+    assert((bit & (bit - 1)) == 0
+           && "flags::flag_counter::count takes a single flag");
+    return bit ? counts_[static_cast<std::size_t>(detail::countr_zero(bit))]
+               : 0;
+  }
+
+  // Number of values counted so far with bit b set, for every b.
+  const counts_type &counts() const noexcept { return counts_; }
+
+  // Number of values counted so far.
+  std::uint64_t total() const noexcept { return total_; }
+
+  void clear() noexcept {
+    counts_.fill(0);
+    total_ = 0;
+  }
+
+
+private:
+  void add_raw(const impl_type *src, std::size_t n) noexcept {
+    detail::bit_slice_counter<impl_type, detail::histogram_isa> counter(
+      counts_.data());
+    std::size_t i = counter.add(src, n);
+    counter.flush();
+    for (; i < n; ++i) {
+      for (std::size_t b = 0; b < flags_type::bit_size(); ++b) {
+        counts_[b] += (src[i] >> b) & 1u;
+      }
+    }
+    total_ += n;
+  }
+
+
+  counts_type counts_;
+  std::uint64_t total_;
+};
+
+
+// Number of the n values with each bit set: element b of the result counts
+// the values with bit b set.
+template <class E>
+typename flag_counter<E>::counts_type
+flag_histogram(const flags<E> *values, std::size_t n) noexcept {
+  flag_counter<E> counter;
+  counter.add(values, n);
+  return counter.counts();
+}
+
+template <class E>
+typename flag_counter<E>::counts_type
+flag_histogram(const flags_vector<E> &column) noexcept {
+  flag_counter<E> counter;
+  counter.add(column);
+  return counter.counts();
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_HISTOGRAM_HPP
@@ -2,6 +2,7 @@
 #define ENUM_CLASS_ITERATOR_HPP
 
 
+#include "bits.hpp"
 #include "flagsfwd.hpp"
 
 #include <iterator>
@@ -18,7 +19,7 @@ public:
   using value_type = E;
   using pointer = value_type *;
   using reference = const value_type;
-  using iterator_category = std::forward_iterator_tag;
+  using iterator_category = std::bidirectional_iterator_tag;
 
 
   constexpr FlagsIterator() noexcept : uvalue_(0), mask_(0) {}
@@ -27,16 +28,26 @@ public:
   : uvalue_(other.uvalue_), mask_(other.mask_) {}
 
 
-  FlagsIterator &operator++() noexcept {
+  ENUM_CLASS_FLAGS_CONSTEXPR14 FlagsIterator &operator++() noexcept {
     nextMask();
     return *this;
   }
-  FlagsIterator operator++(int) noexcept {
+  ENUM_CLASS_FLAGS_CONSTEXPR14 FlagsIterator operator++(int) noexcept {
     auto copy = *this;
     ++(*this);
     return copy;
   }
 
+  ENUM_CLASS_FLAGS_CONSTEXPR14 FlagsIterator &operator--() noexcept {
+    prevMask();
+    return *this;
+  }
+  ENUM_CLASS_FLAGS_CONSTEXPR14 FlagsIterator operator--(int) noexcept {
+    auto copy = *this;
+    --(*this);
+    return copy;
+  }
+
 
   constexpr reference operator*() const noexcept {
     return static_cast<value_type>(mask_);
@@ -60,9 +71,8 @@ private:
   using impl_type = typename flags_type::impl_type;
 
 
-  explicit FlagsIterator(impl_type uv) noexcept : uvalue_(uv), mask_(1) {
-    if (!(mask_ & uvalue_)) { nextMask(); }
-  }
+  constexpr explicit FlagsIterator(impl_type uv) noexcept
+  : uvalue_(uv), mask_(detail::lowest_bit(uv)) {}
 
   constexpr FlagsIterator(impl_type uv, E e) noexcept
   : uvalue_(uv)
@@ -70,8 +80,14 @@ private:
   {}
 
 
-  void nextMask() noexcept {
-    do { mask_ <<= 1; } while (mask_ && !(mask_ & uvalue_));
+  ENUM_CLASS_FLAGS_CONSTEXPR14 void nextMask() noexcept {
+    mask_ = detail::lowest_bit(detail::bits_above(uvalue_, mask_));
+  }
+
+  // From the end, the highest flag.
+  ENUM_CLASS_FLAGS_CONSTEXPR14 void prevMask() noexcept {
+    mask_ = detail::highest_bit(
+      mask_ ? static_cast<impl_type>(uvalue_ & (mask_ - 1)) : uvalue_);
   }
 
 
@@ -0,0 +1,78 @@
+#ifndef ENUM_CLASS_MEMORY_HPP
+#define ENUM_CLASS_MEMORY_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+
+namespace flags {
+namespace detail {
+
+
+constexpr std::size_t cache_line_size = 64;
+
+
+// Allocator handing out storage aligned to Align bytes. It over-allocates
+// and keeps the pointer returned by operator new just before the block.
+template <class T, std::size_t Align = cache_line_size>
+struct aligned_allocator {
+  static_assert(Align && !(Align & (Align - 1)),
+                "alignment must be a power of two");
+
+  using value_type = T;
+
+  template <class U> struct rebind {
+    using other = aligned_allocator<U, Align>;
+  };
+
+
+  aligned_allocator() noexcept = default;
+
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Align> &) noexcept {}
+
+
+  T *allocate(std::size_t n) {
+    void *raw = ::operator new(n * sizeof(T) + Align + sizeof(void *));
+    auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+    address = (address + Align - 1) & ~static_cast<std::uintptr_t>(Align - 1);
+    reinterpret_cast<void **>(address)[-1] = raw;
+    return reinterpret_cast<T *>(address);
+  }
+
+  void deallocate(T *p, std::size_t) noexcept {
+    ::operator delete(reinterpret_cast<void **>(p)[-1]);
+  }
+
+
+  template <class U>
+  friend bool operator==(const aligned_allocator &,
+                         const aligned_allocator<U, Align> &) noexcept {
+    return true;
+  }
+
+  template <class U>
+  friend bool operator!=(const aligned_allocator &,
+                         const aligned_allocator<U, Align> &) noexcept {
+    return false;
+  }
+};
+
+
+// A small number for the calling thread, handed out in order of first use.
+inline std::size_t thread_index() noexcept {
+  static std::atomic<std::size_t> next{0};
+  thread_local const std::size_t index =
+    next.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+
+} // namespace detail
+} // namespace flags
+
+
+#endif // ENUM_CLASS_MEMORY_HPP
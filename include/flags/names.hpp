@@ -0,0 +1,448 @@
+#ifndef ENUM_CLASS_NAMES_HPP
+#define ENUM_CLASS_NAMES_HPP
+
+
+#include "allow_flags.hpp"
+#include "bits.hpp"
+#include "flags.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <system_error>
+#include <type_traits>
+
+
+#if defined(__has_include)
+#  if __has_include(<version>)
+#    include <version>
+#  endif
+#endif
+
+#if defined(__cpp_lib_format) && defined(__cpp_concepts)
+#  define ENUM_CLASS_FLAGS_HAS_STD_FORMAT
+#  include <format>
+#endif
+
+
+namespace flags {
+
+
+// Text conversion of flags<E>. A value is written as the names of its flags
+// in increasing bit order, joined by a delimiter ('|' by default), e.g.
+// "Read|Write". Bits without a name are appended as a single hexadecimal
+// token ("0x40") and the empty set is written as "0". Parsing accepts the
+// same forms, and any enumerator name, including ones spanning several bits.
+//
+// Names are known for enums allowed with ALLOW_FLAGS_FOR_ENUM_VALUES. Under
+// C++14 names are looked up through perfect hash tables built at compile
+// time; under C++11 by a linear search.
+
+
+struct to_chars_result {
+  char *ptr;
+  std::errc ec;
+};
+
+struct from_chars_result {
+  const char *ptr;
+  std::errc ec;
+};
+
+
+template <class E> struct has_enum_names
+: std::integral_constant<bool, enum_names<E>::count != 0> {};
+
+
+namespace detail {
+
+
+template <class E>
+constexpr std::size_t name_lengths(std::size_t i) noexcept {
+  return i == enum_names<E>::count
+         ? 0
+         : enum_names<E>::entries[i].length + name_lengths<E>(i + 1);
+}
+
+template <class E>
+constexpr std::size_t max_chars(std::true_type) noexcept {
+  return name_lengths<E>(0) + enum_names<E>::count;
+}
+
+template <class E>
+constexpr std::size_t max_chars(std::false_type) noexcept { return 0; }
+
+
+ENUM_CLASS_FLAGS_CONSTEXPR14
+inline std::uint32_t name_hash(const char *s, std::size_t n) noexcept {
+  std::uint32_t h = 2166136261u;
+  for (std::size_t i = 0; i < n; ++i) {
+    h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+  }
+  return h;
+}
+
+ENUM_CLASS_FLAGS_CONSTEXPR14
+inline std::uint32_t mix(std::uint32_t h) noexcept {
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  return h ^ (h >> 16);
+}
+
+constexpr std::size_t ceil_pow2(std::size_t n) noexcept {
+  return n <= 1 ? 1 : 2 * ceil_pow2((n + 1) / 2);
+}
+
+
+constexpr unsigned char no_entry = 0xff;
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_CONSTEXPR14
+// Hash-and-displace perfect hashing: a name falls into one of the buckets,
+// and every bucket has a displacement chosen so that its names occupy
+// distinct, otherwise free slots. A lookup hashes the name once, mixes it
+// twice and compares against the single candidate entry.
+template <std::size_t Count> struct name_index {
+  static constexpr std::size_t buckets = ceil_pow2(Count);
+  static constexpr std::size_t slots = 2 * buckets;
+
+  static constexpr std::size_t bucket(std::uint32_t h) noexcept {
+    return mix(h) & (buckets - 1);
+  }
+
+  static constexpr std::size_t slot(std::uint32_t h,
+                                    std::uint16_t displacement) noexcept {
+    return mix(h ^ ((displacement + 1u) * 0x9e3779b9u)) & (slots - 1);
+  }
+
+
+  std::uint16_t displacement[buckets];
+  unsigned char entry[slots];
+  // entry of the first enumerator naming each single bit
+  unsigned char by_bit[64];
+};
+
+
+template <class E>
+constexpr name_index<enum_names<E>::count> build_name_index() noexcept {
+  using names = enum_names<E>;
+  using index_type = name_index<names::count>;
+  constexpr std::size_t count = names::count;
+  constexpr std::size_t buckets = index_type::buckets;
+
+  index_type index{};
+  for (auto &entry : index.entry) { entry = no_entry; }
+  for (auto &entry : index.by_bit) { entry = no_entry; }
+
+  std::uint32_t hashes[count] = {};
+  std::size_t bucket_size[buckets] = {};
+  for (std::size_t i = 0; i < count; ++i) {
+    hashes[i] = name_hash(names::entries[i].name, names::entries[i].length);
+    ++bucket_size[index_type::bucket(hashes[i])];
+
+    const auto value = names::entries[i].value;
+    const auto bit = countr_zero(value);
+    if (value == lowest_bit(value) && value && index.by_bit[bit] == no_entry) {
+      index.by_bit[bit] = static_cast<unsigned char>(i);
+    }
+  }
+
+  // largest buckets first, while most slots are still free
+  bool placed[buckets] = {};
+  for (std::size_t round = 0; round < buckets; ++round) {
+    std::size_t b = 0;
+    while (placed[b]) { ++b; }
+    for (std::size_t c = b + 1; c < buckets; ++c) {
+      if (!placed[c] && bucket_size[c] > bucket_size[b]) { b = c; }
+    }
+    placed[b] = true;
+    if (!bucket_size[b]) { break; }
+
+    for (std::uint16_t d = 0;; ++d) {
+      std::size_t taken[count] = {};
+      std::size_t members = 0;
+      bool fits = true;
+      for (std::size_t i = 0; i < count && fits; ++i) {
+        if (index_type::bucket(hashes[i]) != b) { continue; }
+        const auto s = index_type::slot(hashes[i], d);
+        fits = index.entry[s] == no_entry;
+        for (std::size_t k = 0; k < members; ++k) {
+          fits = fits && taken[k] != s;
+        }
+        taken[members++] = s;
+      }
+      if (!fits) { continue; }
+
+      members = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        if (index_type::bucket(hashes[i]) != b) { continue; }
+        index.entry[taken[members++]] = static_cast<unsigned char>(i);
+      }
+      index.displacement[b] = d;
+      break;
+    }
+  }
+  return index;
+}
+
+
+template <class E> struct name_lookup {
+  static constexpr name_index<enum_names<E>::count> index =
+    build_name_index<E>();
+};
+
+template <class E>
+constexpr name_index<enum_names<E>::count> name_lookup<E>::index;
+#endif
+
+
+// Index of the entry named by [s, s + n), or enum_names<E>::count.
+template <class E>
+std::size_t find_name(const char *, std::size_t, std::false_type) noexcept {
+  return 0;
+}
+
+template <class E>
+std::size_t find_name(const char *s, std::size_t n, std::true_type) noexcept {
+  using names = enum_names<E>;
+#ifdef ENUM_CLASS_FLAGS_HAS_CONSTEXPR14
+  const auto &index = name_lookup<E>::index;
+  const std::uint32_t h = name_hash(s, n);
+  const auto candidate =
+    index.entry[index.slot(h, index.displacement[index.bucket(h)])];
+  if (candidate != no_entry && names::entries[candidate].length == n
+      && !std::memcmp(names::entries[candidate].name, s, n)) {
+    return candidate;
+  }
+  return names::count;
+#else
+  std::size_t i = 0;
+  for (; i < names::count; ++i) {
+    if (names::entries[i].length == n
+        && !std::memcmp(names::entries[i].name, s, n)) {
+      break;
+    }
+  }
+  return i;
+#endif
+}
+
+// Index of the first entry whose value is the single bit, or
+// enum_names<E>::count.
+template <class E, class Impl>
+std::size_t find_bit(Impl, std::false_type) noexcept { return 0; }
+
+template <class E, class Impl>
+std::size_t find_bit(Impl bit, std::true_type) noexcept {
+  using names = enum_names<E>;
+#ifdef ENUM_CLASS_FLAGS_HAS_CONSTEXPR14
+  const auto entry = name_lookup<E>::index.by_bit[countr_zero(bit)];
+  return entry == no_entry ? names::count : entry;
+#else
+  std::size_t i = 0;
+  for (; i < names::count; ++i) {
+    if (names::entries[i].value == bit) { break; }
+  }
+  return i;
+#endif
+}
+
+
+inline bool put(char *&out, char *last, const char *s,
+                std::size_t n) noexcept {
+  if (static_cast<std::size_t>(last - out) < n) { return false; }
+  std::memcpy(out, s, n);
+  out += n;
+  return true;
+}
+
+template <class Impl>
+bool put_hex(char *&out, char *last, Impl value) noexcept {
+  std::size_t digits = 1;
+  while (digits < sizeof(Impl) * 2 && (value >> (digits * 4))) { ++digits; }
+  if (static_cast<std::size_t>(last - out) < digits + 2) { return false; }
+  *out++ = '0';
+  *out++ = 'x';
+  for (std::size_t i = digits; i-- > 0;) {
+    *out++ = "0123456789abcdef"[(value >> (i * 4)) & 0xf];
+  }
+  return true;
+}
+
+template <class Impl>
+bool parse_hex(const char *first, const char *last, Impl &value) noexcept {
+  if (first == last || static_cast<std::size_t>(last - first)
+                         > sizeof(Impl) * 2) {
+    return false;
+  }
+  value = 0;
+  for (; first != last; ++first) {
+    const char c = *first;
+    unsigned digit = 16;
+    if (c >= '0' && c <= '9') { digit = static_cast<unsigned>(c - '0'); }
+    if (c >= 'a' && c <= 'f') { digit = static_cast<unsigned>(c - 'a' + 10); }
+    if (c >= 'A' && c <= 'F') { digit = static_cast<unsigned>(c - 'A' + 10); }
+    if (digit == 16) { return false; }
+    value = static_cast<Impl>((value << 4) | digit);
+  }
+  return true;
+}
+
+
+// Adds the bits of the token [first, last), a name, "0" or a hexadecimal
+// value, to value. Returns false if the token is none of these.
+template <class E, class Impl>
+bool parse_token(const char *first, const char *last, Impl &value) noexcept {
+  using names = enum_names<E>;
+  const auto length = static_cast<std::size_t>(last - first);
+
+  if (length == 1 && *first == '0') { return true; }
+  if (length > 2 && first[0] == '0' && first[1] == 'x') {
+    Impl bits = 0;
+    if (!parse_hex(first + 2, last, bits)) { return false; }
+    value = static_cast<Impl>(value | bits);
+    return true;
+  }
+
+  const std::size_t i = find_name<E>(first, length, has_enum_names<E>{});
+  if (i == names::count) { return false; }
+  value = static_cast<Impl>(value | names::entries[i].value);
+  return true;
+}
+
+
+} // namespace detail
+
+
+// Size of a buffer that fits any value of flags<E> written by to_chars.
+template <class E> constexpr std::size_t max_chars() noexcept {
+  return detail::max_chars<E>(has_enum_names<E>{})
+         + 2 + 2 * sizeof(typename flags<E>::impl_type);
+}
+
+
+// Writes fl to [first, last). On success returns the end of the written
+// text; when it does not fit, returns {last, std::errc::value_too_large}
+// and the contents of the buffer are unspecified.
+template <class E>
+to_chars_result to_chars(char *first, char *last, flags<E> fl,
+                         char delimiter = '|') noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  using names = enum_names<E>;
+  const to_chars_result too_large{last, std::errc::value_too_large};
+
+  auto rest = static_cast<impl_type>(fl.underlying_value());
+  if (!rest) {
+    return detail::put(first, last, "0", 1) ? to_chars_result{first, {}}
+                                            : too_large;
+  }
+
+  impl_type unnamed = 0;
+  bool separate = false;
+  for (; rest; rest = detail::clear_lowest_bit(rest)) {
+    const impl_type bit = detail::lowest_bit(rest);
+    const std::size_t i = detail::find_bit<E>(bit, has_enum_names<E>{});
+    if (i == names::count) {
+      unnamed = static_cast<impl_type>(unnamed | bit);
+      continue;
+    }
+    if ((separate && !detail::put(first, last, &delimiter, 1))
+        || !detail::put(first, last, names::entries[i].name,
+                        names::entries[i].length)) {
+      return too_large;
+    }
+    separate = true;
+  }
+
+  if (unnamed) {
+    if ((separate && !detail::put(first, last, &delimiter, 1))
+        || !detail::put_hex(first, last, unnamed)) {
+      return too_large;
+    }
+  }
+  return {first, {}};
+}
+
+
+// Parses [first, last) as a whole into fl. On failure fl is left unchanged
+// and ptr points to the first offending token.
+template <class E>
+from_chars_result from_chars(const char *first, const char *last,
+                             flags<E> &fl, char delimiter = '|') noexcept {
+  using impl_type = typename flags<E>::impl_type;
+
+  impl_type value = 0;
+  for (const char *token = first;; ++token) {
+    const char *end = token;
+    while (end != last && *end != delimiter) { ++end; }
+    if (!detail::parse_token<E>(token, end, value)) {
+      return {token, std::errc::invalid_argument};
+    }
+    if (end == last) { break; }
+    token = end;
+  }
+
+  fl.set_underlying_value(
+    static_cast<typename flags<E>::underlying_type>(value));
+  return {last, {}};
+}
+
+
+template <class E>
+auto operator<<(std::ostream &o, flags<E> fl)
+-> typename std::enable_if<has_enum_names<E>::value, std::ostream &>::type {
+  char buffer[max_chars<E>()];
+  const auto result = to_chars(buffer, buffer + sizeof(buffer), fl);
+  return o.write(buffer, result.ptr - buffer);
+}
+
+
+} // namespace flags
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_STD_FORMAT
+namespace std {
+template <class E>
+  requires flags::has_enum_names<E>::value
+struct formatter<flags::flags<E>, char> {
+  constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+  auto format(flags::flags<E> fl, std::format_context &ctx) const {
+    char buffer[flags::max_chars<E>()];
+    const auto result = flags::to_chars(buffer, buffer + sizeof(buffer), fl);
+    return std::copy(buffer, result.ptr, ctx.out());
+  }
+};
+} // namespace std
+#endif
+
+
+// fmt support is enabled when fmt is included before this header.
+#ifdef FMT_VERSION
+namespace fmt {
+template <class E>
+struct formatter<flags::flags<E>, char,
+                 typename std::enable_if<
+                   flags::has_enum_names<E>::value>::type> {
+  constexpr auto parse(fmt::format_parse_context &ctx)
+  -> decltype(ctx.begin()) {
+    return ctx.begin();
+  }
+
+  template <class FormatContext>
+  auto format(flags::flags<E> fl, FormatContext &ctx) const
+  -> decltype(ctx.out()) {
+    char buffer[flags::max_chars<E>()];
+    const auto result = flags::to_chars(buffer, buffer + sizeof(buffer), fl);
+    return std::copy(buffer, result.ptr, ctx.out());
+  }
+};
+} // namespace fmt
+#endif
+
+
+#endif // ENUM_CLASS_NAMES_HPP
@@ -0,0 +1,652 @@
+#ifndef ENUM_CLASS_PARALLEL_HPP
+#define ENUM_CLASS_PARALLEL_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+#include "flags_vector.hpp"
+#include "memory.hpp"
+#include "query.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+#if defined(__has_include) && __cplusplus >= 201703L
+#  if __has_include(<execution>)
+#    include <execution>
+#    ifdef __cpp_lib_execution
+#      define ENUM_CLASS_FLAGS_HAS_EXECUTION_POLICIES
+#    endif
+#  endif
+#endif
+
+
+namespace flags {
+namespace detail {
+
+
+// The chunks [first, last) of a parallel_for left to one thread, packed
+// into one word so that the owner and thieves both claim chunks with a
+// single compare-and-swap.
+struct alignas(cache_line_size) chunk_range {
+  std::atomic<std::uint64_t> bounds{0};
+
+  static constexpr std::uint64_t pack(std::uint64_t first,
+                                      std::uint64_t last) noexcept {
+    return first << 32 | last;
+  }
+  static constexpr std::uint64_t first(std::uint64_t bounds) noexcept {
+    return bounds >> 32;
+  }
+  static constexpr std::uint64_t last(std::uint64_t bounds) noexcept {
+    return bounds & 0xffffffffu;
+  }
+};
+
+
+} // namespace detail
+
+
+// A fixed set of threads running one parallel_for at a time. The chunks of
+// a parallel_for are first split evenly between the workers and the calling
+// thread; a thread that runs out of chunks steals the upper half of what is
+// left to another one, so that chunks of uneven cost keep every thread busy
+// until the end.
+class thread_pool {
+public:
+  // A pool of threads threads, counting the thread calling parallel_for,
+  // which takes its share of the chunks: threads - 1 workers are started.
+  explicit thread_pool(std::size_t threads = default_concurrency())
+  : ranges_(threads ? threads : 1) {
+    workers_.reserve(ranges_.size() - 1);
+    for (std::size_t i = 1; i < ranges_.size(); ++i) {
+      workers_.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) { worker.join(); }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+
+  // The pool used by execution::par, with default_concurrency() threads,
+  // started on first use.
+  static thread_pool &shared() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  static std::size_t default_concurrency() noexcept {
+    const unsigned threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+  }
+
+
+  // Number of threads taking part in a parallel_for, the caller included.
+  std::size_t concurrency() const noexcept { return ranges_.size(); }
+
+
+  // Calls f(i) once for every i in [0, chunks), chunks < 2^32, on the
+  // threads of the pool and returns once every call has returned. Calls
+  // from several threads take turns; f must not call parallel_for on the
+  // same pool.
+  template <class F> void parallel_for(std::size_t chunks, F &&f) noexcept {
+    if (chunks < 2 || workers_.empty()) {
+      for (std::size_t i = 0; i < chunks; ++i) { f(i); }
+      return;
+    }
+
+    using function = typename std::remove_reference<F>::type;
+    std::lock_guard<std::mutex> turn(turn_);
+    run_ = &call<function>;
+    context_ = const_cast<void *>(static_cast<const void *>(&f));
+    const std::size_t threads = ranges_.size();
+    for (std::size_t t = 0; t < threads; ++t) {
+      ranges_[t].bounds.store(
+        detail::chunk_range::pack(chunks * t / threads,
+                                  chunks * (t + 1) / threads),
+        std::memory_order_relaxed);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      busy_ = workers_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return busy_ == 0; });
+  }
+
+
+private:
+  template <class F> static void call(void *f, std::size_t chunk) noexcept {
+    (*static_cast<F *>(f))(chunk);
+  }
+
+  void work(std::size_t self) noexcept {
+    std::uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) { return; }
+        seen = generation_;
+      }
+      drain(self);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--busy_ == 0) { idle_.notify_one(); }
+    }
+  }
+
+  void drain(std::size_t self) noexcept {
+    std::size_t chunk;
+    while (claim(self, chunk) || steal(self, chunk)) {
+      run_(context_, chunk);
+    }
+  }
+
+  // Takes the first chunk left to thread self.
+  bool claim(std::size_t self, std::size_t &chunk) noexcept {
+    using range = detail::chunk_range;
+    auto &bounds = ranges_[self].bounds;
+    std::uint64_t b = bounds.load(std::memory_order_relaxed);
+    while (range::first(b) < range::last(b)) {
+      if (bounds.compare_exchange_weak(
+            b, range::pack(range::first(b) + 1, range::last(b)),
+            std::memory_order_relaxed)) {
+        chunk = static_cast<std::size_t>(range::first(b));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes the upper half of the chunks left to the next thread that has
+  // any, runs the first of them and keeps the others. Only the owner of an
+  // empty range stores to it, and nobody steals from an empty range.
+  bool steal(std::size_t self, std::size_t &chunk) noexcept {
+    using range = detail::chunk_range;
+    const std::size_t threads = ranges_.size();
+    for (std::size_t k = 1; k < threads; ++k) {
+      auto &bounds = ranges_[(self + k) % threads].bounds;
+      std::uint64_t b = bounds.load(std::memory_order_relaxed);
+      while (range::first(b) < range::last(b)) {
+        const std::uint64_t first = range::first(b);
+        const std::uint64_t last = range::last(b);
+        const std::uint64_t middle = first + (last - first) / 2;
+        if (bounds.compare_exchange_weak(b, range::pack(first, middle),
+                                         std::memory_order_relaxed)) {
+          ranges_[self].bounds.store(range::pack(middle + 1, last),
+                                     std::memory_order_relaxed);
+          chunk = static_cast<std::size_t>(middle);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+
+  std::vector<detail::chunk_range, detail::aligned_allocator<
+    detail::chunk_range>> ranges_;
+  std::vector<std::thread> workers_;
+
+  // held by the thread running a parallel_for
+  std::mutex turn_;
+  void (*run_)(void *, std::size_t) = nullptr;
+  void *context_ = nullptr;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::uint64_t generation_ = 0;
+  std::size_t busy_ = 0;
+  bool stop_ = false;
+};
+
+
+namespace execution {
+
+
+// Runs an algorithm on the calling thread, in one piece.
+struct sequenced_policy {};
+
+// Runs an algorithm in chunks of chunk_size() elements on the threads of
+// a thread_pool, thread_pool::shared() unless another is given with on().
+// Every chunk goes through the same SIMD kernel as a sequenced run.
+class parallel_policy {
+public:
+  static constexpr std::size_t default_chunk_size = std::size_t{1} << 16;
+
+
+  constexpr parallel_policy() noexcept
+  : pool_(nullptr), chunk_size_(default_chunk_size) {}
+
+
+  constexpr parallel_policy on(thread_pool &pool) const noexcept {
+    return parallel_policy(&pool, chunk_size_);
+  }
+
+  // Chunks of n elements, rounded up to whole 64-element words.
+  constexpr parallel_policy with_chunk_size(std::size_t n) const noexcept {
+    return parallel_policy(pool_, n < 64 ? 64 : (n + 63) / 64 * 64);
+  }
+
+
+  thread_pool &pool() const { return pool_ ? *pool_ : thread_pool::shared(); }
+
+  constexpr std::size_t chunk_size() const noexcept { return chunk_size_; }
+
+
+private:
+  constexpr parallel_policy(thread_pool *pool, std::size_t chunk_size)
+  noexcept : pool_(pool), chunk_size_(chunk_size) {}
+
+
+  thread_pool *pool_;
+  std::size_t chunk_size_;
+};
+
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+
+
+} // namespace execution
+
+
+namespace detail {
+
+
+// Where an algorithm runs: on pool in chunks of chunk_size elements, or on
+// the calling thread in one chunk when pool is null.
+struct executor {
+  thread_pool *pool;
+  std::size_t chunk_size;
+
+
+  std::size_t chunks(std::size_t n) const noexcept {
+    if (!pool || n <= chunk_size) { return n ? 1 : 0; }
+    return (n - 1) / chunk_size + 1;
+  }
+
+  // Calls f(chunk, begin, end) for every chunk [begin, end) of [0, n).
+  template <class F> void for_each_chunk(std::size_t n, F f) const noexcept {
+    const std::size_t count = chunks(n);
+    if (count < 2) {
+      if (count) { f(std::size_t{0}, std::size_t{0}, n); }
+      return;
+    }
+    const std::size_t size = chunk_size;
+    pool->parallel_for(count, [&](std::size_t chunk) {
+      const std::size_t begin = chunk * size;
+      f(chunk, begin, n - begin < size ? n : begin + size);
+    });
+  }
+};
+
+
+inline executor executor_for(execution::sequenced_policy) noexcept {
+  return executor{nullptr, 0};
+}
+
+inline executor executor_for(const execution::parallel_policy &policy) {
+  return executor{&policy.pool(), policy.chunk_size()};
+}
+
+#ifdef ENUM_CLASS_FLAGS_HAS_EXECUTION_POLICIES
+inline executor executor_for(const std::execution::sequenced_policy &)
+noexcept {
+  return executor_for(execution::seq);
+}
+
+inline executor executor_for(const std::execution::parallel_policy &) {
+  return executor_for(execution::par);
+}
+
+inline executor
+executor_for(const std::execution::parallel_unsequenced_policy &) {
+  return executor_for(execution::par);
+}
+
+#  if __cpp_lib_execution >= 201902L
+inline executor executor_for(const std::execution::unsequenced_policy &)
+noexcept {
+  return executor_for(execution::seq);
+}
+#  endif
+#endif
+
+
+template <class T, class = void>
+struct is_execution_policy_impl : std::false_type {};
+
+template <class T>
+struct is_execution_policy_impl<
+  T, decltype(void(executor_for(std::declval<const T &>())))>
+: std::true_type {};
+
+
+} // namespace detail
+
+
+// Whether T, references and cv-qualifiers aside, selects how the algorithms
+// below run: the policies of flags::execution and, where the standard
+// library has them, those of std::execution.
+template <class T>
+struct is_execution_policy
+: detail::is_execution_policy_impl<typename std::decay<T>::type> {};
+
+
+namespace detail {
+
+
+template <class Policy, class R = void>
+using enable_for_policy =
+  typename std::enable_if<is_execution_policy<Policy>::value, R>::type;
+
+
+template <class Op, class Impl>
+void parallel_transform(const executor &ex, Impl *data, std::size_t n,
+                        Impl mask) noexcept {
+  ex.for_each_chunk(n, [=](std::size_t, std::size_t begin, std::size_t end) {
+    transform_broadcast<Op>(data + begin, end - begin, mask);
+  });
+}
+
+template <class Op, class Impl>
+Impl parallel_reduce(const executor &ex, const Impl *data, std::size_t n,
+                     Impl init) noexcept {
+  std::atomic<Impl> result(init);
+  ex.for_each_chunk(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+    const Impl part = reduce_elements<Op>(data + begin, end - begin, init);
+    Impl expected = result.load(std::memory_order_relaxed);
+    while (!result.compare_exchange_weak(expected,
+                                         Op::apply(expected, part),
+                                         std::memory_order_relaxed)) {}
+  });
+  return result.load(std::memory_order_relaxed);
+}
+
+
+// The must_set, must_clear and any_of flags of a predicate as raw values.
+template <class E> struct raw_predicate {
+  using impl_type = typename flags<E>::impl_type;
+
+  explicit raw_predicate(const predicate<E> &p) noexcept
+  : set(static_cast<impl_type>(p.must_set.underlying_value()))
+  , clear(static_cast<impl_type>(p.must_clear.underlying_value()))
+  , any(static_cast<impl_type>(p.any_of.underlying_value())) {}
+
+
+  // Number of elements of src[0, n) that match.
+  std::size_t count(const impl_type *src, std::size_t n) const noexcept {
+    if (!clear && !any) { return count_superset(src, n, set); }
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < n; i += 64) {
+      const std::size_t chunk = n - i < 64 ? n - i : 64;
+      total += static_cast<std::size_t>(
+        popcount(match_word(src + i, chunk, set, clear, any)));
+    }
+    return total;
+  }
+
+  // Copies the elements of src[0, n) that match to yes and the others to
+  // no, in order.
+  void split(const impl_type *src, std::size_t n, impl_type *yes,
+             impl_type *no) const noexcept {
+    for (std::size_t i = 0; i < n; i += 64) {
+      const std::size_t chunk = n - i < 64 ? n - i : 64;
+      std::uint64_t word = match_word(src + i, chunk, set, clear, any);
+      std::uint64_t rest = ~word & (~std::uint64_t{0} >> (64 - chunk));
+      for (; word; word = clear_lowest_bit(word)) {
+        *yes++ = src[i + static_cast<std::size_t>(countr_zero(word))];
+      }
+      for (; rest; rest = clear_lowest_bit(rest)) {
+        *no++ = src[i + static_cast<std::size_t>(countr_zero(rest))];
+      }
+    }
+  }
+
+
+  impl_type set;
+  impl_type clear;
+  impl_type any;
+};
+
+
+template <class E>
+std::size_t parallel_count(const executor &ex,
+                           const typename flags<E>::impl_type *data,
+                           std::size_t n, const predicate<E> &p) noexcept {
+  const raw_predicate<E> match(p);
+  std::atomic<std::size_t> total(0);
+  ex.for_each_chunk(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+    total.fetch_add(match.count(data + begin, end - begin),
+                    std::memory_order_relaxed);
+  });
+  return total.load(std::memory_order_relaxed);
+}
+
+// Stable partition of data[0, n) by p through scratch, of n elements.
+// Returns the number of matches.
+template <class E>
+std::size_t parallel_partition(const executor &ex,
+                               typename flags<E>::impl_type *data,
+                               std::size_t n,
+                               typename flags<E>::impl_type *scratch,
+                               const predicate<E> &p) {
+  const raw_predicate<E> match(p);
+
+  // matches before every chunk
+  std::vector<std::size_t> offsets(ex.chunks(n) + 1);
+  ex.for_each_chunk(n, [&](std::size_t chunk, std::size_t begin,
+                           std::size_t end) {
+    offsets[chunk + 1] = match.count(data + begin, end - begin);
+  });
+  for (std::size_t c = 1; c < offsets.size(); ++c) {
+    offsets[c] += offsets[c - 1];
+  }
+  const std::size_t matches = offsets.back();
+
+  ex.for_each_chunk(n, [&](std::size_t chunk, std::size_t begin,
+                           std::size_t end) {
+    match.split(data + begin, end - begin, scratch + offsets[chunk],
+                scratch + matches + (begin - offsets[chunk]));
+  });
+  ex.for_each_chunk(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+    std::copy(scratch + begin, scratch + end, data + begin);
+  });
+  return matches;
+}
+
+
+} // namespace detail
+
+
+// Bulk operations over arrays of flags. The first argument says how they
+// run: execution::seq or std::execution::seq on the calling thread,
+// execution::par or std::execution::par in chunks on the threads of a
+// thread_pool. Starting the threads of thread_pool::shared() on first use
+// may throw std::system_error.
+
+
+// fl |= mask for every fl of [first, last)
+template <class Policy, class E>
+detail::enable_for_policy<Policy>
+transform_or(Policy &&policy, flags<E> *first, flags<E> *last,
+             flags<E> mask) {
+  using impl_type = typename flags<E>::impl_type;
+  detail::parallel_transform<detail::or_op>(
+    detail::executor_for(policy), detail::raw_data(first),
+    static_cast<std::size_t>(last - first),
+    static_cast<impl_type>(mask.underlying_value()));
+}
+
+// fl &= mask for every fl of [first, last)
+template <class Policy, class E>
+detail::enable_for_policy<Policy>
+transform_and(Policy &&policy, flags<E> *first, flags<E> *last,
+              flags<E> mask) {
+  using impl_type = typename flags<E>::impl_type;
+  detail::parallel_transform<detail::and_op>(
+    detail::executor_for(policy), detail::raw_data(first),
+    static_cast<std::size_t>(last - first),
+    static_cast<impl_type>(mask.underlying_value()));
+}
+
+// fl ^= mask for every fl of [first, last)
+template <class Policy, class E>
+detail::enable_for_policy<Policy>
+transform_xor(Policy &&policy, flags<E> *first, flags<E> *last,
+              flags<E> mask) {
+  using impl_type = typename flags<E>::impl_type;
+  detail::parallel_transform<detail::xor_op>(
+    detail::executor_for(policy), detail::raw_data(first),
+    static_cast<std::size_t>(last - first),
+    static_cast<impl_type>(mask.underlying_value()));
+}
+
+
+// The union of [first, last), empty for an empty range.
+template <class Policy, class E>
+detail::enable_for_policy<Policy, flags<E>>
+reduce_or(Policy &&policy, const flags<E> *first, const flags<E> *last) {
+  using impl_type = typename flags<E>::impl_type;
+  return flags<E>(static_cast<E>(detail::parallel_reduce<detail::or_op>(
+    detail::executor_for(policy), detail::raw_data(first),
+    static_cast<std::size_t>(last - first), impl_type{0})));
+}
+
+// The intersection of [first, last), flags<E>::all() for an empty range.
+template <class Policy, class E>
+detail::enable_for_policy<Policy, flags<E>>
+reduce_and(Policy &&policy, const flags<E> *first, const flags<E> *last) {
+  using impl_type = typename flags<E>::impl_type;
+  const auto all =
+    static_cast<impl_type>(flags<E>::all().underlying_value());
+  return flags<E>(static_cast<E>(detail::parallel_reduce<detail::and_op>(
+    detail::executor_for(policy), detail::raw_data(first),
+    static_cast<std::size_t>(last - first), all)));
+}
+
+
+// Number of elements of [first, last) matching p.
+template <class Policy, class E>
+detail::enable_for_policy<Policy, std::size_t>
+count_if(Policy &&policy, const flags<E> *first, const flags<E> *last,
+         const predicate<E> &p) {
+  return detail::parallel_count(detail::executor_for(policy),
+                                detail::raw_data(first),
+                                static_cast<std::size_t>(last - first), p);
+}
+
+
+// Moves the elements of [first, last) matching p before the others,
+// keeping the order within both groups, and returns the end of the
+// matching ones. buffer has room for last - first elements; one count per
+// chunk is allocated besides.
+template <class Policy, class E>
+detail::enable_for_policy<Policy, flags<E> *>
+partition_by(Policy &&policy, flags<E> *first, flags<E> *last,
+             flags<E> *buffer, const predicate<E> &p) {
+  return first + detail::parallel_partition(
+    detail::executor_for(policy), detail::raw_data(first),
+    static_cast<std::size_t>(last - first), detail::raw_data(buffer), p);
+}
+
+
+// The same operations over the elements of a flags_vector.
+
+template <class Policy, class E>
+detail::enable_for_policy<Policy>
+transform_or(Policy &&policy, flags_vector<E> &column, flags<E> mask) {
+  using impl_type = typename flags<E>::impl_type;
+  detail::parallel_transform<detail::or_op>(
+    detail::executor_for(policy), column.data(), column.size(),
+    static_cast<impl_type>(mask.underlying_value()));
+}
+
+template <class Policy, class E>
+detail::enable_for_policy<Policy>
+transform_and(Policy &&policy, flags_vector<E> &column, flags<E> mask) {
+  using impl_type = typename flags<E>::impl_type;
+  detail::parallel_transform<detail::and_op>(
+    detail::executor_for(policy), column.data(), column.size(),
+    static_cast<impl_type>(mask.underlying_value()));
+}
+
+template <class Policy, class E>
+detail::enable_for_policy<Policy>
+transform_xor(Policy &&policy, flags_vector<E> &column, flags<E> mask) {
+  using impl_type = typename flags<E>::impl_type;
+  detail::parallel_transform<detail::xor_op>(
+    detail::executor_for(policy), column.data(), column.size(),
+    static_cast<impl_type>(mask.underlying_value()));
+}
+
+template <class Policy, class E>
+detail::enable_for_policy<Policy, flags<E>>
+reduce_or(Policy &&policy, const flags_vector<E> &column) {
+  using impl_type = typename flags<E>::impl_type;
+  return flags<E>(static_cast<E>(detail::parallel_reduce<detail::or_op>(
+    detail::executor_for(policy), column.data(), column.size(),
+    impl_type{0})));
+}
+
+template <class Policy, class E>
+detail::enable_for_policy<Policy, flags<E>>
+reduce_and(Policy &&policy, const flags_vector<E> &column) {
+  using impl_type = typename flags<E>::impl_type;
+  const auto all =
+    static_cast<impl_type>(flags<E>::all().underlying_value());
+  return flags<E>(static_cast<E>(detail::parallel_reduce<detail::and_op>(
+    detail::executor_for(policy), column.data(), column.size(),
+    all)));
+}
+
+template <class Policy, class E>
+detail::enable_for_policy<Policy, std::size_t>
+count_if(Policy &&policy, const flags_vector<E> &column,
+         const predicate<E> &p) {
+  return detail::parallel_count(detail::executor_for(policy), column.data(),
+                                column.size(), p);
+}
+
+// Returns the number of matches, which now come first; the buffer is
+// allocated.
+template <class Policy, class E>
+detail::enable_for_policy<Policy, std::size_t>
+partition_by(Policy &&policy, flags_vector<E> &column,
+             const predicate<E> &p) {
+  std::vector<typename flags<E>::impl_type> buffer(column.size());
+  return detail::parallel_partition(detail::executor_for(policy),
+                                    column.data(), column.size(),
+                                    buffer.data(), p);
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_PARALLEL_HPP
@@ -0,0 +1,161 @@
+#ifndef ENUM_CLASS_PARSE_HPP
+#define ENUM_CLASS_PARSE_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+#include "names.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace flags {
+
+
+// Bulk parsing of text holding one flags<E> value per record, e.g. the
+// flag column of a log with records "Read|Write\nExec\n...". Every record
+// is parsed like from_chars, but delimiters and separators are located 64
+// bytes at a time with vector compares, and a malformed record is reported
+// by index instead of stopping the parse.
+
+
+// A record holding a token that is not a name of E, "0" or a hexadecimal
+// value.
+struct record_error {
+  // index of the record, counted from the start of the input
+  std::size_t record;
+  // offset of its first offending token from the start of the input
+  std::size_t position;
+};
+
+struct parse_records_result {
+  // end of the text consumed: last, or the start of the first record not
+  // parsed because out was full
+  const char *ptr;
+  // number of records parsed and written to out
+  std::size_t records;
+  // number of malformed records among them, including the ones that did
+  // not fit in errors
+  std::size_t errors;
+};
+
+
+namespace detail {
+
+
+template <class E> class record_parser {
+public:
+  using impl_type = typename flags<E>::impl_type;
+  using underlying_type = typename flags<E>::underlying_type;
+
+
+  record_parser(const char *first, flags<E> *out, std::size_t capacity,
+                record_error *errors, std::size_t error_capacity) noexcept
+  : first_(first), token_(first), record_(first), out_(out),
+    capacity_(capacity), errors_(errors), error_capacity_(error_capacity) {}
+
+
+  void end_token(const char *end, const char *last) noexcept {
+    if (!parse_token<E>(token_, end, value_) && !bad_) { bad_ = token_; }
+    token_ = end == last ? last : end + 1;
+  }
+
+  void end_record(const char *end, const char *last) noexcept {
+    end_token(end, last);
+    out_[records_].set_underlying_value(static_cast<underlying_type>(value_));
+    if (bad_) {
+      if (error_count_ < error_capacity_) {
+        errors_[error_count_] = record_error{
+          records_, static_cast<std::size_t>(bad_ - first_)};
+      }
+      ++error_count_;
+    }
+    ++records_;
+    value_ = 0;
+    bad_ = nullptr;
+    record_ = token_;
+  }
+
+  bool full() const noexcept { return records_ == capacity_; }
+
+  const char *record() const noexcept { return record_; }
+
+  parse_records_result result(const char *ptr) const noexcept {
+    return {ptr, records_, error_count_};
+  }
+
+private:
+  const char *first_;
+  const char *token_;
+  const char *record_;
+  flags<E> *out_;
+  std::size_t capacity_;
+  record_error *errors_;
+  std::size_t error_capacity_;
+
+  impl_type value_ = 0;
+  const char *bad_ = nullptr;
+  std::size_t records_ = 0;
+  std::size_t error_count_ = 0;
+};
+
+
+} // namespace detail
+
+
+// Parses the records of [first, last), separated by separator and made of
+// tokens separated by delimiter, into out[0], out[1], ... and stops after
+// capacity records. A final record need not end with a separator; an empty
+// record is malformed.
+//
+// A malformed record still gets the bits of its valid tokens in out, and
+// the first error_capacity malformed records are described in errors.
+template <class E>
+parse_records_result parse_records(const char *first, const char *last,
+                                   flags<E> *out, std::size_t capacity,
+                                   record_error *errors = nullptr,
+                                   std::size_t error_capacity = 0,
+                                   char delimiter = '|',
+                                   char separator = '\n') noexcept {
+  detail::record_parser<E> parser{first, out, capacity, errors,
+                                  error_capacity};
+  if (parser.full()) { return parser.result(first); }
+
+  const char *block = first;
+  for (; last - block >= 64; block += 64) {
+    std::uint64_t delimiters;
+    std::uint64_t separators;
+    detail::find_bytes64(block, delimiter, separator, delimiters, separators);
+
+    for (auto ends = delimiters | separators; ends;
+         ends = detail::clear_lowest_bit(ends)) {
+      const int i = detail::countr_zero(ends);
+      if ((separators >> i) & 1) {
+        parser.end_record(block + i, last);
+        if (parser.full()) { return parser.result(parser.record()); }
+      } else {
+        parser.end_token(block + i, last);
+      }
+    }
+  }
+
+  for (; block != last; ++block) {
+    if (*block == separator) {
+      parser.end_record(block, last);
+      if (parser.full()) { return parser.result(parser.record()); }
+    } else if (*block == delimiter) {
+      parser.end_token(block, last);
+    }
+  }
+
+  if (parser.record() != last) { parser.end_record(last, last); }
+  return parser.result(last);
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_PARSE_HPP
@@ -0,0 +1,229 @@
+#ifndef ENUM_CLASS_PREPROCESSOR_HPP
+#define ENUM_CLASS_PREPROCESSOR_HPP
+
+
+// ENUM_CLASS_FLAGS_FOR_EACH(m, data, x1, ..., xn) expands to
+// m(data, x1) ... m(data, xn) for up to 64 arguments. The extra
+// ENUM_CLASS_FLAGS_EXPAND steps make MSVC's traditional preprocessor split
+// __VA_ARGS__ the same way as conforming ones.
+
+
+#define ENUM_CLASS_FLAGS_EXPAND(x) x
+
+#define ENUM_CLASS_FLAGS_CAT_(a, b) a##b
+#define ENUM_CLASS_FLAGS_CAT(a, b) ENUM_CLASS_FLAGS_CAT_(a, b)
+
+#define ENUM_CLASS_FLAGS_NARG(...) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_NARG_(__VA_ARGS__, \
+    64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, \
+    46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, \
+    28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, \
+    10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define ENUM_CLASS_FLAGS_NARG_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, \
+                               _12, _13, _14, _15, _16, _17, _18, _19, _20, \
+                               _21, _22, _23, _24, _25, _26, _27, _28, _29, \
+                               _30, _31, _32, _33, _34, _35, _36, _37, _38, \
+                               _39, _40, _41, _42, _43, _44, _45, _46, _47, \
+                               _48, _49, _50, _51, _52, _53, _54, _55, _56, \
+                               _57, _58, _59, _60, _61, _62, _63, _64, n, \
+                               ...) n
+
+#define ENUM_CLASS_FLAGS_FOR_EACH(m, data, ...) \
+  ENUM_CLASS_FLAGS_EXPAND( \
+    ENUM_CLASS_FLAGS_CAT(ENUM_CLASS_FLAGS_FOR_EACH_, \
+                         ENUM_CLASS_FLAGS_NARG(__VA_ARGS__)) \
+    (m, data, __VA_ARGS__))
+
+#define ENUM_CLASS_FLAGS_FOR_EACH_1(m, data, x) m(data, x)
+#define ENUM_CLASS_FLAGS_FOR_EACH_2(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_1(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_3(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_2(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_4(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_3(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_5(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_4(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_6(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_5(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_7(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_6(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_8(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_7(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_9(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_8(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_10(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_9(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_11(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_10(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_12(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_11(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_13(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_12(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_14(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_13(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_15(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_14(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_16(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_15(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_17(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_16(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_18(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_17(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_19(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_18(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_20(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_19(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_21(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_20(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_22(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_21(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_23(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_22(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_24(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_23(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_25(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_24(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_26(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_25(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_27(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_26(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_28(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_27(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_29(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_28(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_30(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_29(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_31(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_30(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_32(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_31(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_33(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_32(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_34(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_33(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_35(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_34(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_36(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_35(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_37(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_36(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_38(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_37(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_39(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_38(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_40(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_39(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_41(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_40(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_42(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_41(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_43(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_42(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_44(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_43(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_45(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_44(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_46(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_45(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_47(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_46(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_48(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_47(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_49(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_48(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_50(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_49(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_51(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_50(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_52(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_51(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_53(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_52(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_54(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_53(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_55(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_54(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_56(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_55(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_57(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_56(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_58(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_57(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_59(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_58(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_60(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_59(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_61(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_60(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_62(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_61(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_63(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_62(m, data, __VA_ARGS__))
+#define ENUM_CLASS_FLAGS_FOR_EACH_64(m, data, x, ...) \
+  m(data, x) \
+  ENUM_CLASS_FLAGS_EXPAND(ENUM_CLASS_FLAGS_FOR_EACH_63(m, data, __VA_ARGS__))
+
+
+#endif // ENUM_CLASS_PREPROCESSOR_HPP
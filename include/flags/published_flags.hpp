@@ -0,0 +1,195 @@
+#ifndef ENUM_CLASS_PUBLISHED_FLAGS_HPP
+#define ENUM_CLASS_PUBLISHED_FLAGS_HPP
+
+
+#include "flags.hpp"
+#include "memory.hpp"
+#include "simd.hpp"
+#include "wide_flags.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace flags {
+namespace detail {
+
+
+// Waits a moment in a spin loop: a pause instruction for the first spins,
+// then giving the core away in case the thread waited for was preempted.
+inline void spin_wait(unsigned spins) noexcept {
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  if (spins < 64) {
+    _mm_pause();
+    return;
+  }
+#else
+  (void)spins;
+#endif
+  std::this_thread::yield();
+}
+
+
+// The number of readers of one slot inside load(), for each of the two
+// reader phases, alone on their cache line.
+struct alignas(cache_line_size) reader_slot {
+  std::atomic<std::size_t> readers[2];
+
+  reader_slot() noexcept {
+    readers[0].store(0, std::memory_order_relaxed);
+    readers[1].store(0, std::memory_order_relaxed);
+  }
+};
+
+
+} // namespace detail
+
+
+// A wide_flags<E, Bits> read by many threads all the time and replaced now
+// and then. Each published set is an immutable copy behind an atomic
+// pointer: publishing swaps in a new copy, and reading copies the set the
+// pointer refers to. Reads are wait-free, a fixed number of steps whatever
+// other threads do, and never see a mix of two published sets.
+//
+// A replaced copy is deleted once no reader can still be reading it. Each
+// reader counts itself in, in the slot of its thread and the current of
+// two phases, for the duration of its copy. After swapping the pointer, a
+// publisher waits for the readers of the other phase, switches the phase,
+// and waits for the readers of the former one: readers that come later
+// only find the new copy, so each wait is for reads already under way.
+// Publishers take turns on a mutex and are the only ones that ever wait.
+template <class E, std::size_t Bits> class published_flags {
+public:
+  using flags_type = wide_flags<E, Bits>;
+
+
+  published_flags() : published_flags(flags_type{empty_t{}}) {}
+
+  // Reader slots as for flags_accumulator: at least slots, rounded up to a
+  // power of two, one per hardware thread by default.
+  explicit published_flags(const flags_type &fl,
+                           std::size_t slots = default_slots())
+  : current_(nullptr), phase_(0), version_(0), slots_(round_up(slots)) {
+    current_.store(new flags_type(fl), std::memory_order_relaxed);
+  }
+
+  published_flags(const published_flags &) = delete;
+  published_flags &operator=(const published_flags &) = delete;
+
+  ~published_flags() { delete current_.load(std::memory_order_relaxed); }
+
+
+  static std::size_t default_slots() noexcept {
+    const unsigned threads = std::thread::hardware_concurrency();
+    return threads ? threads : 1;
+  }
+
+  std::size_t slot_count() const noexcept { return slots_.size(); }
+
+
+  // The set last published. Wait-free: one load of the phase, one of the
+  // pointer and the copy, between an increment and a decrement of a
+  // counter of the slot of the calling thread.
+  flags_type load() const noexcept {
+    auto &slot = slots_[detail::thread_index() & (slots_.size() - 1)];
+    auto &readers = slot.readers[phase_.load(std::memory_order_seq_cst)];
+    readers.fetch_add(1, std::memory_order_seq_cst);
+    const flags_type fl = *current_.load(std::memory_order_seq_cst);
+    readers.fetch_sub(1, std::memory_order_release);
+    return fl;
+  }
+
+  operator flags_type() const noexcept { return load(); }
+
+  // Number of publishes so far.
+  std::uint64_t version() const noexcept {
+    return version_.load(std::memory_order_acquire);
+  }
+
+
+  void publish(const flags_type &fl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    replace(fl);
+  }
+
+  // Publishes f(s) for the set s last published, with no publish in
+  // between, and returns it.
+  template <class F> flags_type update(F f) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const flags_type fl = f(*current_.load(std::memory_order_relaxed));
+    replace(fl);
+    return fl;
+  }
+
+  void insert(E e) {
+    update([e](flags_type fl) {
+      fl.insert(e);
+      return fl;
+    });
+  }
+
+  void erase(E e) {
+    update([e](flags_type fl) {
+      fl.erase(e);
+      return fl;
+    });
+  }
+
+
+private:
+  using slot_type = detail::reader_slot;
+
+
+  static std::size_t round_up(std::size_t slots) noexcept {
+    std::size_t size = 1;
+    while (size < slots) { size *= 2; }
+    return size;
+  }
+
+  // For the publisher holding the mutex. The new copy is made before
+  // anything changes, so that a failed allocation leaves the set as it
+  // was.
+  void replace(const flags_type &fl) {
+    const flags_type *next = new flags_type(fl);
+    const flags_type *old =
+      current_.exchange(next, std::memory_order_seq_cst);
+    version_.fetch_add(1, std::memory_order_release);
+
+    const unsigned phase = phase_.load(std::memory_order_relaxed);
+    drain(phase ^ 1);
+    phase_.store(phase ^ 1, std::memory_order_seq_cst);
+    drain(phase);
+    delete old;
+  }
+
+  // Waits until no reader of phase is inside load().
+  void drain(unsigned phase) const noexcept {
+    for (const auto &slot : slots_) {
+      for (unsigned spins = 0;
+           slot.readers[phase].load(std::memory_order_seq_cst); ++spins) {
+        detail::spin_wait(spins);
+      }
+    }
+  }
+
+
+  // read by every reader, written by publishers only
+  alignas(detail::cache_line_size)
+    std::atomic<const flags_type *> current_;
+  std::atomic<unsigned> phase_;
+  std::atomic<std::uint64_t> version_;
+  mutable std::vector<slot_type, detail::aligned_allocator<slot_type>>
+    slots_;
+
+  alignas(detail::cache_line_size) std::mutex mutex_;
+};
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_PUBLISHED_FLAGS_HPP
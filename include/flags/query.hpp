@@ -0,0 +1,223 @@
+#ifndef ENUM_CLASS_QUERY_HPP
+#define ENUM_CLASS_QUERY_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+#include "flags_vector.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace flags {
+
+
+// A condition on a single flags<E> value: every flag of must_set present,
+// every flag of must_clear absent and, unless any_of is empty, at least one
+// flag of any_of present.
+template <class E> struct predicate {
+  using flags_type = flags<E>;
+
+
+  constexpr predicate() noexcept
+  : must_set(empty_t{}), must_clear(empty_t{}), any_of(empty_t{}) {}
+
+  constexpr explicit predicate(flags_type set,
+                               flags_type clear = flags_type{empty_t{}},
+                               flags_type any = flags_type{empty_t{}}) noexcept
+  : must_set(set), must_clear(clear), any_of(any) {}
+
+
+  constexpr predicate with(flags_type fl) const noexcept {
+    return predicate{must_set | fl, must_clear, any_of};
+  }
+
+  constexpr predicate without(flags_type fl) const noexcept {
+    return predicate{must_set, must_clear | fl, any_of};
+  }
+
+  constexpr predicate with_any_of(flags_type fl) const noexcept {
+    return predicate{must_set, must_clear, any_of | fl};
+  }
+
+
+  constexpr bool operator()(flags_type fl) const noexcept {
+    return fl.all_of(must_set) && fl.none_of(must_clear)
+           && (!any_of || fl.any_of(any_of));
+  }
+
+
+  flags_type must_set;
+  flags_type must_clear;
+  flags_type any_of;
+};
+
+
+// Number of words in a selection bitmap over n elements. Bit i % 64 of
+// word i / 64 stands for element i; bits past the last element are zero.
+constexpr std::size_t selection_words(std::size_t n) noexcept {
+  return (n + 63) / 64;
+}
+
+
+namespace detail {
+
+
+// The elements of an array of flags<E> as the impl_type words they are made
+// of, as in flags_vector.
+template <class E>
+typename flags<E>::impl_type *raw_data(flags<E> *p) noexcept {
+  static_assert(sizeof(flags<E>) == sizeof(typename flags<E>::impl_type),
+                "flags<E> must have the layout of impl_type");
+  return reinterpret_cast<typename flags<E>::impl_type *>(p);
+}
+
+template <class E>
+const typename flags<E>::impl_type *raw_data(const flags<E> *p) noexcept {
+  return raw_data(const_cast<flags<E> *>(p));
+}
+
+
+template <class Op, class E>
+void match_into(const typename flags<E>::impl_type *src, std::size_t n,
+                const predicate<E> &p, std::uint64_t *bitmap) noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  const auto set = static_cast<impl_type>(p.must_set.underlying_value());
+  const auto clear = static_cast<impl_type>(p.must_clear.underlying_value());
+  const auto any = static_cast<impl_type>(p.any_of.underlying_value());
+
+  for (std::size_t i = 0; i < n; i += 64, ++bitmap) {
+    const std::size_t count = n - i < 64 ? n - i : 64;
+    *bitmap = Op::apply(*bitmap,
+                        match_word(src + i, count, set, clear, any));
+  }
+}
+
+
+inline void clear_selection(std::uint64_t *bitmap, std::size_t n) noexcept {
+  for (std::size_t w = 0; w < selection_words(n); ++w) { bitmap[w] = 0; }
+}
+
+
+// Writes base + i for every set bit i of word to out and returns their
+// number. The loop runs popcount(word) times and has no other branches.
+inline std::size_t expand_word(std::uint64_t word, std::size_t base,
+                               std::size_t *out) noexcept {
+  const int bits = popcount(word);
+  for (int j = 0; j < bits; ++j) {
+    out[j] = base + static_cast<std::size_t>(countr_zero(word));
+    word = clear_lowest_bit(word);
+  }
+  return static_cast<std::size_t>(bits);
+}
+
+
+template <class E>
+std::size_t match_indices(const typename flags<E>::impl_type *src,
+                          std::size_t n, const predicate<E> &p,
+                          std::size_t *out) noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  const auto set = static_cast<impl_type>(p.must_set.underlying_value());
+  const auto clear = static_cast<impl_type>(p.must_clear.underlying_value());
+  const auto any = static_cast<impl_type>(p.any_of.underlying_value());
+
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; i += 64) {
+    const std::size_t chunk = n - i < 64 ? n - i : 64;
+    const std::uint64_t word = match_word(src + i, chunk, set, clear, any);
+    count += expand_word(word, i, out + count);
+  }
+  return count;
+}
+
+
+} // namespace detail
+
+
+// Writes the elements of [first, first + n) matching p to a selection
+// bitmap of selection_words(n) words.
+template <class E>
+void select(const flags<E> *first, std::size_t n, const predicate<E> &p,
+            std::uint64_t *bitmap) noexcept {
+  detail::clear_selection(bitmap, n);
+  detail::match_into<detail::or_op>(detail::raw_data(first), n, p, bitmap);
+}
+
+template <class E>
+void select(const flags_vector<E> &column, const predicate<E> &p,
+            std::uint64_t *bitmap) noexcept {
+  detail::clear_selection(bitmap, column.size());
+  detail::match_into<detail::or_op>(column.data(), column.size(), p,
+                                    bitmap);
+}
+
+// Keeps only the selected elements that also match p.
+template <class E>
+void refine(const flags<E> *first, std::size_t n, const predicate<E> &p,
+            std::uint64_t *bitmap) noexcept {
+  detail::match_into<detail::and_op>(detail::raw_data(first), n, p, bitmap);
+}
+
+template <class E>
+void refine(const flags_vector<E> &column, const predicate<E> &p,
+            std::uint64_t *bitmap) noexcept {
+  detail::match_into<detail::and_op>(column.data(), column.size(), p,
+                                     bitmap);
+}
+
+// Adds the elements matching p to the selection.
+template <class E>
+void extend(const flags<E> *first, std::size_t n, const predicate<E> &p,
+            std::uint64_t *bitmap) noexcept {
+  detail::match_into<detail::or_op>(detail::raw_data(first), n, p, bitmap);
+}
+
+template <class E>
+void extend(const flags_vector<E> &column, const predicate<E> &p,
+            std::uint64_t *bitmap) noexcept {
+  detail::match_into<detail::or_op>(column.data(), column.size(), p,
+                                    bitmap);
+}
+
+
+// Number of elements in a selection bitmap over n elements.
+inline std::size_t selection_size(const std::uint64_t *bitmap,
+                                  std::size_t n) noexcept {
+  return detail::popcount_words(bitmap, selection_words(n));
+}
+
+// Writes the indices of the elements in a selection bitmap over n elements
+// to out, in increasing order, and returns their number.
+inline std::size_t selection_indices(const std::uint64_t *bitmap,
+                                     std::size_t n,
+                                     std::size_t *out) noexcept {
+  std::size_t count = 0;
+  for (std::size_t w = 0; w < selection_words(n); ++w) {
+    count += detail::expand_word(bitmap[w], w * 64, out + count);
+  }
+  return count;
+}
+
+// Writes the indices of the elements of [first, first + n) matching p to
+// out, which must have room for n indices, and returns their number.
+template <class E>
+std::size_t select_indices(const flags<E> *first, std::size_t n,
+                           const predicate<E> &p,
+                           std::size_t *out) noexcept {
+  return detail::match_indices(detail::raw_data(first), n, p, out);
+}
+
+template <class E>
+std::size_t select_indices(const flags_vector<E> &column,
+                           const predicate<E> &p,
+                           std::size_t *out) noexcept {
+  return detail::match_indices(column.data(), column.size(), p, out);
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_QUERY_HPP
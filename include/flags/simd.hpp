@@ -0,0 +1,545 @@
+#ifndef ENUM_CLASS_SIMD_HPP
+#define ENUM_CLASS_SIMD_HPP
+
+
+#include "bits.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+#if defined(__AVX2__)
+#  define ENUM_CLASS_FLAGS_HAS_AVX2
+#  define ENUM_CLASS_FLAGS_HAS_SSE2
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) \
+      || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define ENUM_CLASS_FLAGS_HAS_SSE2
+#  include <emmintrin.h>
+#endif
+
+
+namespace flags {
+namespace detail {
+
+
+// Kernels over arrays of unsigned integers of any width. Each one processes
+// as many elements as possible with the widest vector instructions the
+// target was compiled for (native_isa) and finishes the tail with a scalar
+// loop, which compilers are free to vectorize as well.
+
+
+template <std::size_t Size>
+using width_tag = std::integral_constant<std::size_t, Size>;
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+struct sse2_isa {
+  using vector = __m128i;
+  static constexpr std::size_t bytes = 16;
+
+  static vector load(const void *p) noexcept {
+    return _mm_loadu_si128(static_cast<const __m128i *>(p));
+  }
+  static void store(void *p, vector v) noexcept {
+    _mm_storeu_si128(static_cast<__m128i *>(p), v);
+  }
+
+  template <class T> static vector broadcast(T x) noexcept {
+    return broadcast(x, width_tag<sizeof(T)>{});
+  }
+  static vector broadcast(std::uint64_t x, width_tag<1>) noexcept {
+    return _mm_set1_epi8(static_cast<char>(x));
+  }
+  static vector broadcast(std::uint64_t x, width_tag<2>) noexcept {
+    return _mm_set1_epi16(static_cast<short>(x));
+  }
+  static vector broadcast(std::uint64_t x, width_tag<4>) noexcept {
+    return _mm_set1_epi32(static_cast<int>(x));
+  }
+  static vector broadcast(std::uint64_t x, width_tag<8>) noexcept {
+    return _mm_set1_epi64x(static_cast<long long>(x));
+  }
+
+  // All ones in every element of a equal to the element of b.
+  static vector equal(vector a, vector b, width_tag<1>) noexcept {
+    return _mm_cmpeq_epi8(a, b);
+  }
+  static vector equal(vector a, vector b, width_tag<2>) noexcept {
+    return _mm_cmpeq_epi16(a, b);
+  }
+  static vector equal(vector a, vector b, width_tag<4>) noexcept {
+    return _mm_cmpeq_epi32(a, b);
+  }
+  static vector equal(vector a, vector b, width_tag<8>) noexcept {
+    const vector halves = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(halves,
+                         _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+
+  // One bit per byte, taken from the top bit of the byte.
+  static unsigned byte_mask(vector v) noexcept {
+    return static_cast<unsigned>(_mm_movemask_epi8(v));
+  }
+
+  // One bit per element, for vectors holding all ones or all zeros in
+  // every element.
+  static unsigned element_mask(vector v, width_tag<1>) noexcept {
+    return byte_mask(v);
+  }
+  static unsigned element_mask(vector v, width_tag<2>) noexcept {
+    return byte_mask(_mm_packs_epi16(v, _mm_setzero_si128()));
+  }
+  static unsigned element_mask(vector v, width_tag<4>) noexcept {
+    return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(v)));
+  }
+  static unsigned element_mask(vector v, width_tag<8>) noexcept {
+    return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(v)));
+  }
+
+  static vector add64(vector a, vector b) noexcept {
+    return _mm_add_epi64(a, b);
+  }
+
+  static vector byte_popcount(vector v) noexcept {
+    const vector m1 = _mm_set1_epi8(0x55);
+    const vector m2 = _mm_set1_epi8(0x33);
+    const vector m4 = _mm_set1_epi8(0x0f);
+    v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), m1));
+    v = _mm_add_epi8(_mm_and_si128(v, m2),
+                     _mm_and_si128(_mm_srli_epi16(v, 2), m2));
+    return _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi16(v, 4)), m4);
+  }
+
+  // Sums byte counts so that the lowest byte of every element holds the
+  // population count of that element.
+  static vector fold_bytes(vector v, width_tag<1>) noexcept { return v; }
+  static vector fold_bytes(vector v, width_tag<2>) noexcept {
+    return _mm_add_epi8(v, _mm_srli_epi16(v, 8));
+  }
+  static vector fold_bytes(vector v, width_tag<4>) noexcept {
+    v = _mm_add_epi8(v, _mm_srli_epi32(v, 16));
+    return _mm_add_epi8(v, _mm_srli_epi32(v, 8));
+  }
+  static vector fold_bytes(vector v, width_tag<8>) noexcept {
+    return _mm_sad_epu8(v, _mm_setzero_si128());
+  }
+};
+#endif
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_AVX2
+struct avx2_isa {
+  using vector = __m256i;
+  static constexpr std::size_t bytes = 32;
+
+  static vector load(const void *p) noexcept {
+    return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+  }
+  static void store(void *p, vector v) noexcept {
+    _mm256_storeu_si256(static_cast<__m256i *>(p), v);
+  }
+
+  template <class T> static vector broadcast(T x) noexcept {
+    return broadcast(x, width_tag<sizeof(T)>{});
+  }
+  static vector broadcast(std::uint64_t x, width_tag<1>) noexcept {
+    return _mm256_set1_epi8(static_cast<char>(x));
+  }
+  static vector broadcast(std::uint64_t x, width_tag<2>) noexcept {
+    return _mm256_set1_epi16(static_cast<short>(x));
+  }
+  static vector broadcast(std::uint64_t x, width_tag<4>) noexcept {
+    return _mm256_set1_epi32(static_cast<int>(x));
+  }
+  static vector broadcast(std::uint64_t x, width_tag<8>) noexcept {
+    return _mm256_set1_epi64x(static_cast<long long>(x));
+  }
+
+  static vector equal(vector a, vector b, width_tag<1>) noexcept {
+    return _mm256_cmpeq_epi8(a, b);
+  }
+  static vector equal(vector a, vector b, width_tag<2>) noexcept {
+    return _mm256_cmpeq_epi16(a, b);
+  }
+  static vector equal(vector a, vector b, width_tag<4>) noexcept {
+    return _mm256_cmpeq_epi32(a, b);
+  }
+  static vector equal(vector a, vector b, width_tag<8>) noexcept {
+    return _mm256_cmpeq_epi64(a, b);
+  }
+
+  static unsigned byte_mask(vector v) noexcept {
+    return static_cast<unsigned>(_mm256_movemask_epi8(v));
+  }
+
+  static unsigned element_mask(vector v, width_tag<1>) noexcept {
+    return byte_mask(v);
+  }
+  static unsigned element_mask(vector v, width_tag<2>) noexcept {
+    // packing works within 128-bit lanes, leaving the two halves of the
+    // mask in bits 0-7 and 16-23
+    const unsigned m = byte_mask(_mm256_packs_epi16(v, _mm256_setzero_si256()));
+    return (m & 0xffu) | ((m >> 8) & 0xff00u);
+  }
+  static unsigned element_mask(vector v, width_tag<4>) noexcept {
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(v)));
+  }
+  static unsigned element_mask(vector v, width_tag<8>) noexcept {
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(v)));
+  }
+
+  static vector add64(vector a, vector b) noexcept {
+    return _mm256_add_epi64(a, b);
+  }
+
+  // Nibble lookups (Mula, Kurz, Lemire).
+  static vector byte_popcount(vector v) noexcept {
+    const vector lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const vector low_mask = _mm256_set1_epi8(0x0f);
+    const vector lo = _mm256_and_si256(v, low_mask);
+    const vector hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                           _mm256_shuffle_epi8(lookup, hi));
+  }
+
+  static vector fold_bytes(vector v, width_tag<1>) noexcept { return v; }
+  static vector fold_bytes(vector v, width_tag<2>) noexcept {
+    return _mm256_add_epi8(v, _mm256_srli_epi16(v, 8));
+  }
+  static vector fold_bytes(vector v, width_tag<4>) noexcept {
+    v = _mm256_add_epi8(v, _mm256_srli_epi32(v, 16));
+    return _mm256_add_epi8(v, _mm256_srli_epi32(v, 8));
+  }
+  static vector fold_bytes(vector v, width_tag<8>) noexcept {
+    return _mm256_sad_epu8(v, _mm256_setzero_si256());
+  }
+};
+#endif
+
+
+#if defined(ENUM_CLASS_FLAGS_HAS_AVX2)
+using native_isa = avx2_isa;
+#elif defined(ENUM_CLASS_FLAGS_HAS_SSE2)
+using native_isa = sse2_isa;
+#endif
+
+
+// Bitwise operations, each usable on scalars and on native vectors.
+
+struct and_op {
+  template <class T> static T apply(T a, T b) noexcept {
+    return static_cast<T>(a & b);
+  }
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  static __m128i apply(__m128i a, __m128i b) noexcept {
+    return _mm_and_si128(a, b);
+  }
+#endif
+#ifdef ENUM_CLASS_FLAGS_HAS_AVX2
+  static __m256i apply(__m256i a, __m256i b) noexcept {
+    return _mm256_and_si256(a, b);
+  }
+#endif
+};
+
+struct or_op {
+  template <class T> static T apply(T a, T b) noexcept {
+    return static_cast<T>(a | b);
+  }
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  static __m128i apply(__m128i a, __m128i b) noexcept {
+    return _mm_or_si128(a, b);
+  }
+#endif
+#ifdef ENUM_CLASS_FLAGS_HAS_AVX2
+  static __m256i apply(__m256i a, __m256i b) noexcept {
+    return _mm256_or_si256(a, b);
+  }
+#endif
+};
+
+struct xor_op {
+  template <class T> static T apply(T a, T b) noexcept {
+    return static_cast<T>(a ^ b);
+  }
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  static __m128i apply(__m128i a, __m128i b) noexcept {
+    return _mm_xor_si128(a, b);
+  }
+#endif
+#ifdef ENUM_CLASS_FLAGS_HAS_AVX2
+  static __m256i apply(__m256i a, __m256i b) noexcept {
+    return _mm256_xor_si256(a, b);
+  }
+#endif
+};
+
+// a & ~b
+struct andnot_op {
+  template <class T> static T apply(T a, T b) noexcept {
+    return static_cast<T>(a & ~b);
+  }
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  static __m128i apply(__m128i a, __m128i b) noexcept {
+    return _mm_andnot_si128(b, a);
+  }
+#endif
+#ifdef ENUM_CLASS_FLAGS_HAS_AVX2
+  static __m256i apply(__m256i a, __m256i b) noexcept {
+    return _mm256_andnot_si256(b, a);
+  }
+#endif
+};
+
+
+// dst[i] = Op::apply(dst[i], src[i]) for i in [0, n)
+template <class Op, class T>
+inline void transform_elements(T *dst, const T *src, std::size_t n) noexcept {
+  std::size_t i = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  for (; i + lanes <= n; i += lanes) {
+    isa::store(dst + i, Op::apply(isa::load(dst + i), isa::load(src + i)));
+  }
+#endif
+  for (; i < n; ++i) { dst[i] = Op::apply(dst[i], src[i]); }
+}
+
+// dst[i] = Op::apply(dst[i], mask) for i in [0, n)
+template <class Op, class T>
+inline void transform_broadcast(T *dst, std::size_t n, T mask) noexcept {
+  std::size_t i = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  const typename isa::vector vmask = isa::broadcast(mask);
+  for (; i + lanes <= n; i += lanes) {
+    isa::store(dst + i, Op::apply(isa::load(dst + i), vmask));
+  }
+#endif
+  for (; i < n; ++i) { dst[i] = Op::apply(dst[i], mask); }
+}
+
+
+// Op::apply of init and every src[i] for i in [0, n)
+template <class Op, class T>
+inline T reduce_elements(const T *src, std::size_t n, T init) noexcept {
+  std::size_t i = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  if (n >= lanes) {
+    auto acc = isa::load(src);
+    for (i = lanes; i + lanes <= n; i += lanes) {
+      acc = Op::apply(acc, isa::load(src + i));
+    }
+    T values[isa::bytes / sizeof(T)];
+    isa::store(values, acc);
+    for (auto value : values) { init = Op::apply(init, value); }
+  }
+#endif
+  for (; i < n; ++i) { init = Op::apply(init, src[i]); }
+  return init;
+}
+
+
+// Number of elements in [0, n) that have every bit of mask set.
+template <class T>
+inline std::size_t count_superset(const T *src, std::size_t n,
+                                  T mask) noexcept {
+  std::size_t i = 0;
+  std::size_t total = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  const typename isa::vector vmask = isa::broadcast(mask);
+  std::size_t matching_bytes = 0;
+  for (; i + lanes <= n; i += lanes) {
+    const auto common = and_op::apply(isa::load(src + i), vmask);
+    const auto eq = isa::equal(common, vmask, width_tag<sizeof(T)>{});
+    matching_bytes += static_cast<std::size_t>(popcount(isa::byte_mask(eq)));
+  }
+  total = matching_bytes / sizeof(T);
+#endif
+  for (; i < n; ++i) { total += (src[i] & mask) == mask; }
+  return total;
+}
+
+// Index of the first element in [0, n) that has every bit of mask set, or n.
+template <class T>
+inline std::size_t find_superset(const T *src, std::size_t n,
+                                 T mask) noexcept {
+  std::size_t i = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  const typename isa::vector vmask = isa::broadcast(mask);
+  for (; i + lanes <= n; i += lanes) {
+    const auto common = and_op::apply(isa::load(src + i), vmask);
+    const auto eq = isa::equal(common, vmask, width_tag<sizeof(T)>{});
+    if (const unsigned bytes = isa::byte_mask(eq)) {
+      return i + static_cast<std::size_t>(countr_zero(bytes)) / sizeof(T);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    if ((src[i] & mask) == mask) { break; }
+  }
+  return i;
+}
+
+
+// Bit i of the result is set when src[i], i in [0, n) and n <= 64, has
+// every bit of set, no bit of clear and, unless any is zero, some bit of any.
+template <class T>
+inline std::uint64_t match_word(const T *src, std::size_t n,
+                                T set, T clear, T any) noexcept {
+  std::uint64_t word = 0;
+  std::size_t i = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  using width = width_tag<sizeof(T)>;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  const auto vset = isa::broadcast(set);
+  const auto vclear = isa::broadcast(clear);
+  const auto vany = isa::broadcast(any);
+  const auto zero = isa::broadcast(T{0});
+  const std::uint64_t any_required = std::uint64_t{0} - (any != 0);
+  for (; i + lanes <= n; i += lanes) {
+    const auto v = isa::load(src + i);
+    const auto has_set = isa::equal(and_op::apply(v, vset), vset, width{});
+    const auto lacks_clear = isa::equal(and_op::apply(v, vclear), zero,
+                                        width{});
+    const auto lacks_any = isa::equal(and_op::apply(v, vany), zero, width{});
+    const std::uint64_t pass =
+      isa::element_mask(and_op::apply(has_set, lacks_clear), width{});
+    const std::uint64_t fail = isa::element_mask(lacks_any, width{});
+    word |= (pass & ~(fail & any_required)) << i;
+  }
+#endif
+  for (; i < n; ++i) {
+    const bool matches = ((src[i] & set) == set) & ((src[i] & clear) == 0)
+                         & ((any == 0) | ((src[i] & any) != 0));
+    word |= std::uint64_t{matches} << i;
+  }
+  return word;
+}
+
+
+// out[i] = popcount(src[i]) for i in [0, n)
+template <class T>
+inline void popcount_elements(const T *src, std::size_t n,
+                              unsigned char *out) noexcept {
+  std::size_t i = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const std::size_t lanes = isa::bytes / sizeof(T);
+  for (; i + lanes <= n; i += lanes) {
+    alignas(isa::bytes) T counts[isa::bytes / sizeof(T)];
+    isa::store(counts, isa::fold_bytes(isa::byte_popcount(isa::load(src + i)),
+                                       width_tag<sizeof(T)>{}));
+    for (std::size_t j = 0; j < lanes; ++j) {
+      out[i + j] = static_cast<unsigned char>(counts[j] & 0xff);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = static_cast<unsigned char>(popcount(src[i]));
+  }
+}
+
+
+// Total number of set bits in n words.
+inline std::size_t popcount_words(const std::uint64_t *src,
+                                  std::size_t n) noexcept {
+  std::size_t i = 0;
+  std::size_t total = 0;
+#if defined(ENUM_CLASS_FLAGS_HAS_AVX2)
+  const bool vectorize = n >= 8;
+#elif defined(ENUM_CLASS_FLAGS_HAS_SSE2)
+  // a popcount instruction beats the SSE2 reduction on its own
+#  ifdef ENUM_CLASS_FLAGS_HAS_BUILTIN_POPCOUNT
+  const bool vectorize = false;
+#  else
+  const bool vectorize = n >= 4;
+#  endif
+#endif
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  if (vectorize) {
+    using isa = native_isa;
+    const std::size_t lanes = isa::bytes / sizeof(std::uint64_t);
+    auto acc = isa::broadcast(std::uint64_t{0});
+    for (; i + lanes <= n; i += lanes) {
+      const auto counts = isa::byte_popcount(isa::load(src + i));
+      acc = isa::add64(acc, isa::fold_bytes(counts, width_tag<8>{}));
+    }
+    alignas(isa::bytes) std::uint64_t sums[isa::bytes / 8];
+    isa::store(sums, acc);
+    for (auto sum : sums) { total += static_cast<std::size_t>(sum); }
+  }
+#endif
+  for (; i < n; ++i) { total += static_cast<std::size_t>(popcount(src[i])); }
+  return total;
+}
+
+
+// Bit i of in_a (in_b) is set when p[i], i in [0, 64), equals a (b).
+inline void find_bytes64(const char *p, char a, char b, std::uint64_t &in_a,
+                         std::uint64_t &in_b) noexcept {
+  in_a = 0;
+  in_b = 0;
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  using isa = native_isa;
+  const auto va = isa::broadcast(static_cast<std::uint8_t>(a));
+  const auto vb = isa::broadcast(static_cast<std::uint8_t>(b));
+  for (std::size_t i = 0; i < 64; i += isa::bytes) {
+    const auto v = isa::load(p + i);
+    in_a |= std::uint64_t{isa::byte_mask(isa::equal(v, va, width_tag<1>{}))}
+            << i;
+    in_b |= std::uint64_t{isa::byte_mask(isa::equal(v, vb, width_tag<1>{}))}
+            << i;
+  }
+#else
+  for (std::size_t i = 0; i < 64; ++i) {
+    in_a |= std::uint64_t{p[i] == a} << i;
+    in_b |= std::uint64_t{p[i] == b} << i;
+  }
+#endif
+}
+
+
+// Bit i of the result is set when p[i], i in [0, 16), equals b.
+inline unsigned find_byte16(const signed char *p, signed char b) noexcept {
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  return sse2_isa::byte_mask(sse2_isa::equal(
+    sse2_isa::load(p), sse2_isa::broadcast(static_cast<std::uint8_t>(b)),
+    width_tag<1>{}));
+#else
+  unsigned mask = 0;
+  for (unsigned i = 0; i < 16; ++i) { mask |= unsigned{p[i] == b} << i; }
+  return mask;
+#endif
+}
+
+// Bit i of the result is set when p[i], i in [0, 16), is negative.
+inline unsigned find_negative16(const signed char *p) noexcept {
+#ifdef ENUM_CLASS_FLAGS_HAS_SSE2
+  return sse2_isa::byte_mask(sse2_isa::load(p));
+#else
+  unsigned mask = 0;
+  for (unsigned i = 0; i < 16; ++i) { mask |= unsigned{p[i] < 0} << i; }
+  return mask;
+#endif
+}
+
+
+} // namespace detail
+} // namespace flags
+
+
+#endif // ENUM_CLASS_SIMD_HPP
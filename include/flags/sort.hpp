@@ -0,0 +1,190 @@
+#ifndef ENUM_CLASS_SORT_HPP
+#define ENUM_CLASS_SORT_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+
+namespace flags {
+namespace detail {
+
+
+// Below this many elements a comparison sort beats clearing and summing the
+// histograms.
+constexpr std::size_t radix_sort_threshold = 64;
+
+
+template <class E>
+typename flags<E>::impl_type raw_value(flags<E> fl) noexcept {
+  return static_cast<typename flags<E>::impl_type>(fl.underlying_value());
+}
+
+template <class Impl>
+unsigned radix_digit(Impl value, unsigned pass) noexcept {
+  return static_cast<unsigned>(value >> (pass * 8)) & 0xffu;
+}
+
+
+// Counts of every byte value at every byte position, and of every size
+// when sorting by size_order, from one pass over the keys.
+template <class Impl> struct radix_histograms {
+  static constexpr unsigned passes = sizeof(Impl);
+
+  std::size_t digits[passes][256];
+  std::size_t sizes[sizeof(Impl) * 8 + 1];
+
+
+  template <class Key>
+  radix_histograms(std::size_t n, Key key, bool by_size) noexcept
+  : digits{}, sizes{} {
+    for (std::size_t i = 0; i < n; ++i) {
+      const Impl value = key(i);
+      for (unsigned p = 0; p < passes; ++p) {
+        ++digits[p][radix_digit(value, p)];
+      }
+      if (by_size) { ++sizes[popcount(value)]; }
+    }
+  }
+};
+
+// Turns counts into the first position of every bucket. Returns false,
+// leaving the counts as they are, when one bucket holds all n elements and
+// the pass would not move anything.
+template <std::size_t Buckets>
+bool radix_offsets(std::size_t (&counts)[Buckets], std::size_t n) noexcept {
+  for (auto c : counts) {
+    if (c == n) { return false; }
+  }
+  std::size_t sum = 0;
+  for (auto &c : counts) {
+    const std::size_t count = c;
+    c = sum;
+    sum += count;
+  }
+  return true;
+}
+
+
+// One stable counting-sort pass of items source(0)..source(n-1) to dst.
+template <class T, class Source, class Bucket, std::size_t Buckets>
+void radix_scatter(Source source, T *dst, std::size_t n, Bucket bucket,
+                   std::size_t (&offsets)[Buckets]) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    const T item = source(i);
+    dst[offsets[bucket(item)]++] = item;
+  }
+}
+
+
+// LSD radix sort of the n items source(0)..source(n-1) by key(item), byte
+// by byte from the lowest, then by the size of the key when by_size is set.
+// The passes alternate between buffer and out, starting with buffer, so
+// that source may read from out; both have room for n items. Returns where
+// the sorted items ended up, or null when they were already in order and
+// nothing was written.
+template <class Impl, class T, class Source, class Key>
+const T *radix_sort_items(Source source, T *out, T *buffer, std::size_t n,
+                          Key key, bool by_size) noexcept {
+  radix_histograms<Impl> counts(
+    n, [&](std::size_t i) { return key(source(i)); }, by_size);
+
+  const T *src = nullptr;
+  T *dst = buffer;
+  auto next = [&](std::size_t i) { return src ? src[i] : source(i); };
+  for (unsigned p = 0; p < counts.passes; ++p) {
+    if (!radix_offsets(counts.digits[p], n)) { continue; }
+    radix_scatter(next, dst, n,
+                  [&](T item) { return radix_digit(key(item), p); },
+                  counts.digits[p]);
+    src = dst;
+    dst = dst == out ? buffer : out;
+  }
+  if (by_size && radix_offsets(counts.sizes, n)) {
+    radix_scatter(next, dst, n, [&](T item) { return popcount(key(item)); },
+                  counts.sizes);
+    src = dst;
+  }
+  return src;
+}
+
+
+} // namespace detail
+
+
+// Sorts [first, last) in increasing order (see operator< of flags) in
+// linear time, with buffer as scratch space for last - first elements.
+// Passes over bytes where every element has the same value are skipped, so
+// keys using only their low bits sort in fewer passes.
+template <class E>
+void radix_sort(flags<E> *first, flags<E> *last, flags<E> *buffer) noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  const auto n = static_cast<std::size_t>(last - first);
+  if (n < detail::radix_sort_threshold) {
+    std::sort(first, last);
+    return;
+  }
+  const flags<E> *sorted = detail::radix_sort_items<impl_type>(
+    [first](std::size_t i) { return first[i]; }, first, buffer, n,
+    [](flags<E> fl) { return detail::raw_value(fl); }, false);
+  if (sorted && sorted != first) { std::copy(sorted, sorted + n, first); }
+}
+
+// Sorts [first, last) by size_order in linear time.
+template <class E>
+void radix_sort(flags<E> *first, flags<E> *last, flags<E> *buffer,
+                size_order order) noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  const auto n = static_cast<std::size_t>(last - first);
+  if (n < detail::radix_sort_threshold) {
+    std::sort(first, last, order);
+    return;
+  }
+  const flags<E> *sorted = detail::radix_sort_items<impl_type>(
+    [first](std::size_t i) { return first[i]; }, first, buffer, n,
+    [](flags<E> fl) { return detail::raw_value(fl); }, true);
+  if (sorted && sorted != first) { std::copy(sorted, sorted + n, first); }
+}
+
+
+// Sorts [first, last), drops repeated values and returns the end of the
+// distinct values, which are left in increasing order.
+template <class E>
+flags<E> *sort_unique(flags<E> *first, flags<E> *last,
+                      flags<E> *buffer) noexcept {
+  radix_sort(first, last, buffer);
+  return std::unique(first, last);
+}
+
+
+// Groups the n elements of keys by value: writes their indices to order,
+// by increasing key and, among equal keys, by increasing index, and
+// returns the number of distinct keys. The groups are the runs of equal
+// keys[order[i]]. order and buffer have room for n indices each.
+template <class E>
+std::size_t group_by(const flags<E> *keys, std::size_t n, std::size_t *order,
+                     std::size_t *buffer) noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  auto key = [keys](std::size_t i) { return detail::raw_value(keys[i]); };
+  const std::size_t *sorted = detail::radix_sort_items<impl_type>(
+    [](std::size_t i) { return i; }, order, buffer, n, key, false);
+  if (!sorted) {
+    for (std::size_t i = 0; i < n; ++i) { order[i] = i; }
+  } else if (sorted != order) {
+    std::copy(sorted, sorted + n, order);
+  }
+
+  std::size_t groups = n ? 1 : 0;
+  for (std::size_t i = 1; i < n; ++i) {
+    groups += keys[order[i]] != keys[order[i - 1]] ? 1 : 0;
+  }
+  return groups;
+}
+
+
+} // namespace flags
+
+#endif // ENUM_CLASS_SORT_HPP
@@ -0,0 +1,206 @@
+#ifndef ENUM_CLASS_SUBSETS_HPP
+#define ENUM_CLASS_SUBSETS_HPP
+
+
+#include "bits.hpp"
+#include "flags.hpp"
+
+#include <cstddef>
+#include <iterator>
+
+
+namespace flags {
+
+
+// Walks base | s for every subset s of mask, in increasing order of s, with
+// the recurrence s' = (s - mask) & mask.
+template <class E>
+class SubsetIterator {
+public:
+  using flags_type = flags<E>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = flags_type;
+  using pointer = const value_type *;
+  using reference = const value_type;
+  using iterator_category = std::forward_iterator_tag;
+
+
+  // The end of every walk.
+  constexpr SubsetIterator() noexcept
+  : base_(0), mask_(0), cur_(0), done_(true) {}
+
+  constexpr SubsetIterator(flags_type base, flags_type mask) noexcept
+  : base_(raw(base)), mask_(raw(mask)), cur_(0), done_(false) {}
+
+
+  ENUM_CLASS_FLAGS_CONSTEXPR14 SubsetIterator &operator++() noexcept {
+    cur_ = static_cast<impl_type>((cur_ - mask_) & mask_);
+    done_ = cur_ == 0;
+    return *this;
+  }
+
+  ENUM_CLASS_FLAGS_CONSTEXPR14 SubsetIterator operator++(int) noexcept {
+    auto copy = *this;
+    ++(*this);
+    return copy;
+  }
+
+
+  constexpr reference operator*() const noexcept {
+    return flags_type(static_cast<E>(base_ | cur_));
+  }
+
+
+  friend constexpr bool operator==(const SubsetIterator &i,
+                                   const SubsetIterator &j) noexcept {
+    return i.done_ == j.done_ && (i.done_ || i.cur_ == j.cur_);
+  }
+
+  friend constexpr bool operator!=(const SubsetIterator &i,
+                                   const SubsetIterator &j) noexcept {
+    return !(i == j);
+  }
+
+
+private:
+  using impl_type = typename flags_type::impl_type;
+
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+
+  impl_type base_;
+  impl_type mask_;
+  impl_type cur_;
+  bool done_;
+};
+
+
+// Walks the subsets of mask with k flags, in increasing order, with
+// Gosper's recurrence carried over the set bits of mask: the lowest run of
+// flags moves up by one flag of mask and all but one of its flags drop to
+// the lowest flags of mask.
+template <class E>
+class CombinationIterator {
+public:
+  using flags_type = flags<E>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = flags_type;
+  using pointer = const value_type *;
+  using reference = const value_type;
+  using iterator_category = std::forward_iterator_tag;
+
+
+  // The end of every walk.
+  constexpr CombinationIterator() noexcept
+  : mask_(0), cur_(0), done_(true) {}
+
+  constexpr CombinationIterator(flags_type mask, std::size_t k) noexcept
+  : mask_(raw(mask))
+  , cur_(detail::lowest_bits(raw(mask), static_cast<unsigned>(k)))
+  , done_(static_cast<std::size_t>(detail::popcount(raw(mask))) < k) {}
+
+
+  ENUM_CLASS_FLAGS_CONSTEXPR14 CombinationIterator &operator++() noexcept {
+    // the bits outside mask carry the increment across the gaps
+    const impl_type next = static_cast<impl_type>(
+      ((cur_ | ~mask_) + detail::lowest_bit(cur_)) & mask_);
+    if ((next & ~cur_) == 0) {
+      done_ = true;
+      return *this;
+    }
+    const int run = detail::popcount(static_cast<impl_type>(cur_ & ~next));
+    cur_ = static_cast<impl_type>(
+      next | detail::lowest_bits(mask_, static_cast<unsigned>(run - 1)));
+    return *this;
+  }
+
+  ENUM_CLASS_FLAGS_CONSTEXPR14
+  CombinationIterator operator++(int) noexcept {
+    auto copy = *this;
+    ++(*this);
+    return copy;
+  }
+
+
+  constexpr reference operator*() const noexcept {
+    return flags_type(static_cast<E>(cur_));
+  }
+
+
+  friend constexpr bool operator==(const CombinationIterator &i,
+                                   const CombinationIterator &j) noexcept {
+    return i.done_ == j.done_ && (i.done_ || i.cur_ == j.cur_);
+  }
+
+  friend constexpr bool operator!=(const CombinationIterator &i,
+                                   const CombinationIterator &j) noexcept {
+    return !(i == j);
+  }
+
+
+private:
+  using impl_type = typename flags_type::impl_type;
+
+  static constexpr impl_type raw(flags_type fl) noexcept {
+    return static_cast<impl_type>(fl.underlying_value());
+  }
+
+
+  impl_type mask_;
+  impl_type cur_;
+  bool done_;
+};
+
+
+// A pair of iterators, for range-for.
+template <class Iterator> class flags_range {
+public:
+  using iterator = Iterator;
+  using value_type = typename Iterator::value_type;
+
+
+  constexpr explicit flags_range(Iterator first) noexcept
+  : first_(first) {}
+
+  constexpr Iterator begin() const noexcept { return first_; }
+  constexpr Iterator end() const noexcept { return Iterator{}; }
+
+  constexpr bool empty() const noexcept { return first_ == Iterator{}; }
+
+
+private:
+  Iterator first_;
+};
+
+
+// Every subset of fl, from the empty set up to fl itself.
+template <class E>
+constexpr flags_range<SubsetIterator<E>> subsets(flags<E> fl) noexcept {
+  return flags_range<SubsetIterator<E>>{
+    SubsetIterator<E>{flags<E>{empty_t{}}, fl}};
+}
+
+// Every set containing fl and contained in universe, from fl itself up to
+// universe; nothing if fl is not a subset of universe.
+template <class E>
+constexpr flags_range<SubsetIterator<E>>
+supersets_within(flags<E> fl, flags<E> universe) noexcept {
+  return flags_range<SubsetIterator<E>>{
+    fl.is_subset_of(universe) ? SubsetIterator<E>{fl, universe & ~fl}
+                              : SubsetIterator<E>{}};
+}
+
+// Every subset of fl with k flags, in increasing order.
+template <class E>
+constexpr flags_range<CombinationIterator<E>>
+combinations(flags<E> fl, std::size_t k) noexcept {
+  return flags_range<CombinationIterator<E>>{CombinationIterator<E>{fl, k}};
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_SUBSETS_HPP
@@ -0,0 +1,489 @@
+#ifndef ENUM_CLASS_WIDE_FLAGS_HPP
+#define ENUM_CLASS_WIDE_FLAGS_HPP
+
+
+#include "allow_flags.hpp"
+#include "bits.hpp"
+#include "flags.hpp"
+#include "simd.hpp"
+
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+
+namespace flags {
+
+
+namespace detail {
+
+constexpr std::size_t word_bits = 64;
+
+constexpr std::size_t word_count(std::size_t bits) noexcept {
+  return (bits + word_bits - 1) / word_bits;
+}
+
+} // namespace detail
+
+
+template <class E, std::size_t Bits> class wide_flags;
+
+
+template <class E, std::size_t Bits>
+class WideFlagsIterator {
+public:
+  using flags_type = wide_flags<E, Bits>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = E;
+  using pointer = value_type *;
+  using reference = const value_type;
+  using iterator_category = std::forward_iterator_tag;
+
+
+  constexpr WideFlagsIterator() noexcept : words_(nullptr), index_(Bits) {}
+
+
+  WideFlagsIterator &operator++() noexcept {
+    seek(index_ + 1);
+    return *this;
+  }
+  WideFlagsIterator operator++(int) noexcept {
+    auto copy = *this;
+    ++(*this);
+    return copy;
+  }
+
+
+  constexpr reference operator*() const noexcept {
+    return static_cast<value_type>(index_);
+  }
+
+
+  friend inline constexpr bool operator==(const WideFlagsIterator &i,
+                                          const WideFlagsIterator &j) noexcept {
+    return i.index_ == j.index_;
+  }
+
+  friend inline constexpr bool operator!=(const WideFlagsIterator &i,
+                                          const WideFlagsIterator &j) noexcept {
+    return i.index_ != j.index_;
+  }
+
+
+private:
+  template <class E_, std::size_t Bits_> friend class wide_flags;
+
+  using word_type = std::uint64_t;
+
+
+  constexpr WideFlagsIterator(const word_type *words, std::size_t index)
+  noexcept
+  : words_(words), index_(index) {}
+
+
+  // Moves to the first set bit at or after index, skipping zero words; to
+  // the end from index Bits on.
+  void seek(std::size_t index) noexcept {
+    if (index >= Bits) {
+      index_ = Bits;
+      return;
+    }
+    const std::size_t count = detail::word_count(Bits);
+    std::size_t w = index / detail::word_bits;
+    word_type word = words_[w]
+                     & (~word_type{0} << (index % detail::word_bits));
+    while (!word) {
+      if (++w == count) {
+        index_ = Bits;
+        return;
+      }
+      word = words_[w];
+    }
+    index_ = w * detail::word_bits
+             + static_cast<std::size_t>(detail::countr_zero(word));
+  }
+
+
+  const word_type *words_;
+  std::size_t index_;
+};
+
+
+// A set of flags for enums with more enumerators than fit a machine word.
+// The enumerators of E are bit indices in [0, Bits) and the set is stored as
+// an array of 64-bit words. The interface mirrors flags<E>, except that
+// iterators refer to the container they came from rather than to a copy of
+// its value.
+template <class E, std::size_t Bits> class wide_flags {
+public:
+  static_assert(is_wide_flags<E>::value,
+                "flags::wide_flags is disallowed for this type; "
+                "use ALLOW_WIDE_FLAGS_FOR_ENUM macro.");
+  static_assert(Bits > 0, "flags::wide_flags must hold at least one flag");
+
+  using enum_type = typename std::decay<E>::type;
+  using word_type = std::uint64_t;
+
+  using iterator = WideFlagsIterator<enum_type, Bits>;
+  using const_iterator = iterator;
+  using value_type = typename iterator::value_type;
+  using reference = typename iterator::reference;
+  using const_reference = typename iterator::reference;
+  using pointer = enum_type *;
+  using const_pointer = const enum_type *;
+  using size_type = std::size_t;
+  using difference_type = typename iterator::difference_type;
+
+
+  constexpr static std::size_t bit_size() { return Bits; }
+  constexpr static std::size_t word_count() {
+    return detail::word_count(Bits);
+  }
+
+
+private:
+  template <class T, class Res = std::nullptr_t>
+  using convertible = std::enable_if<std::is_convertible<T, enum_type>::value,
+                                     Res>;
+
+
+public:
+  wide_flags() noexcept = default;
+  wide_flags(const wide_flags &fl) noexcept = default;
+  wide_flags &operator=(const wide_flags &fl) noexcept = default;
+  wide_flags(wide_flags &&fl) noexcept = default;
+  wide_flags &operator=(wide_flags &&fl) noexcept = default;
+
+
+  explicit constexpr wide_flags(empty_t) noexcept : words_() {}
+
+
+#ifdef ENUM_CLASS_FLAGS_FORBID_IMPLICT_CONVERSION
+  explicit
+#endif
+  wide_flags(enum_type e) noexcept : words_() { set_bit(index_of(e)); }
+
+  wide_flags &operator=(enum_type e) noexcept {
+    clear();
+    set_bit(index_of(e));
+    return *this;
+  }
+
+
+  wide_flags(std::initializer_list<enum_type> il) noexcept : words_() {
+    insert(il);
+  }
+
+  wide_flags &operator=(std::initializer_list<enum_type> il) noexcept {
+    clear();
+    insert(il);
+    return *this;
+  }
+
+  template <class ... Args>
+  wide_flags(enum_type e, Args ... args) noexcept : wide_flags{e, args...} {}
+
+
+  template <class FwIter>
+  wide_flags(FwIter b, FwIter e,
+             typename convertible<decltype(*b)>::type = nullptr)
+  noexcept(noexcept(std::declval<wide_flags>().insert(
+                      std::declval<FwIter>(), std::declval<FwIter>())))
+  : words_()
+  { insert(b, e); }
+
+
+  explicit operator bool() const noexcept { return !empty(); }
+
+  bool operator!() const noexcept { return empty(); }
+
+  friend bool operator==(const wide_flags &fl1, const wide_flags &fl2) {
+    for (std::size_t w = 0; w < word_count(); ++w) {
+      if (fl1.words_[w] != fl2.words_[w]) { return false; }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const wide_flags &fl1, const wide_flags &fl2) {
+    return !(fl1 == fl2);
+  }
+
+
+  wide_flags operator~() const noexcept {
+    wide_flags result = *this;
+    for (auto &word : result.words_) { word = ~word; }
+    result.trim();
+    return result;
+  }
+
+  wide_flags &operator|=(const wide_flags &fl) noexcept {
+    detail::transform_elements<detail::or_op>(words_, fl.words_,
+                                              word_count());
+    return *this;
+  }
+
+  wide_flags &operator&=(const wide_flags &fl) noexcept {
+    detail::transform_elements<detail::and_op>(words_, fl.words_,
+                                              word_count());
+    return *this;
+  }
+
+  wide_flags &operator^=(const wide_flags &fl) noexcept {
+    detail::transform_elements<detail::xor_op>(words_, fl.words_,
+                                              word_count());
+    return *this;
+  }
+
+
+  wide_flags &operator|=(enum_type e) noexcept {
+    set_bit(index_of(e));
+    return *this;
+  }
+
+  wide_flags &operator&=(enum_type e) noexcept {
+    const bool was_set = test_bit(index_of(e));
+    clear();
+    if (was_set) { set_bit(index_of(e)); }
+    return *this;
+  }
+
+  wide_flags &operator^=(enum_type e) noexcept {
+    const std::size_t i = index_of(e);
+    words_[i / detail::word_bits] ^= bit_of(i);
+    return *this;
+  }
+
+  friend wide_flags operator|(wide_flags fl1, const wide_flags &fl2) noexcept {
+    fl1 |= fl2;
+    return fl1;
+  }
+
+  friend wide_flags operator&(wide_flags fl1, const wide_flags &fl2) noexcept {
+    fl1 &= fl2;
+    return fl1;
+  }
+
+  friend wide_flags operator^(wide_flags fl1, const wide_flags &fl2) noexcept {
+    fl1 ^= fl2;
+    return fl1;
+  }
+
+
+  void swap(wide_flags &fl) noexcept {
+    for (std::size_t w = 0; w < word_count(); ++w) {
+      std::swap(words_[w], fl.words_[w]);
+    }
+  }
+
+
+  // The words of the set, lowest first. Bits past Bits in the last word
+  // must stay zero.
+  word_type *data() noexcept { return words_; }
+  const word_type *data() const noexcept { return words_; }
+
+
+  explicit operator std::bitset<Bits>() const noexcept { return to_bitset(); }
+
+  std::bitset<Bits> to_bitset() const noexcept {
+    std::bitset<Bits> result;
+    for (std::size_t w = word_count(); w-- > 0;) {
+      result <<= detail::word_bits;
+      result |= std::bitset<Bits>(words_[w]);
+    }
+    return result;
+  }
+
+
+  bool empty() const noexcept {
+    word_type any = 0;
+    for (auto word : words_) { any |= word; }
+    return !any;
+  }
+
+  size_type size() const noexcept {
+    return detail::popcount_words(words_, word_count());
+  }
+
+  constexpr size_type max_size() const noexcept { return bit_size(); }
+
+
+  iterator begin() const noexcept { return cbegin(); }
+  iterator cbegin() const noexcept {
+    iterator i{words_, 0};
+    i.seek(0);
+    return i;
+  }
+
+  constexpr iterator end() const noexcept { return cend(); }
+  constexpr iterator cend() const noexcept { return {}; }
+
+
+  iterator find(enum_type e) const noexcept {
+    const std::size_t i = index_of(e);
+    return test_bit(i) ? iterator{words_, i} : end();
+  }
+
+  size_type count(enum_type e) const noexcept {
+    return test_bit(index_of(e)) ? 1 : 0;
+  }
+
+  size_type count_in(const wide_flags &mask) const noexcept {
+    wide_flags common = *this;
+    common &= mask;
+    return common.size();
+  }
+
+  bool any_of(const wide_flags &mask) const noexcept {
+    word_type any = 0;
+    for (std::size_t w = 0; w < word_count(); ++w) {
+      any |= words_[w] & mask.words_[w];
+    }
+    return any != 0;
+  }
+
+  bool all_of(const wide_flags &mask) const noexcept {
+    word_type missing = 0;
+    for (std::size_t w = 0; w < word_count(); ++w) {
+      missing |= mask.words_[w] & ~words_[w];
+    }
+    return !missing;
+  }
+
+  bool none_of(const wide_flags &mask) const noexcept {
+    return !any_of(mask);
+  }
+
+
+  // The first flag not below e, a single flag, and the first flag above e.
+  iterator lower_bound(enum_type e) const noexcept {
+    iterator i{words_, 0};
+    i.seek(index_of(e));
+    return i;
+  }
+
+  iterator upper_bound(enum_type e) const noexcept {
+    iterator i{words_, 0};
+    i.seek(index_of(e) + 1);
+    return i;
+  }
+
+  std::pair<iterator, iterator> equal_range(enum_type e) const noexcept {
+    return {lower_bound(e), upper_bound(e)};
+  }
+
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args && ... args) noexcept {
+    return insert(enum_type{args...});
+  }
+
+  template <class... Args>
+  iterator emplace_hint(iterator, Args && ... args) noexcept {
+    return emplace(args...).first;
+  }
+
+
+  std::pair<iterator, bool> insert(enum_type e) noexcept {
+    const std::size_t i = index_of(e);
+    const bool inserted = !test_bit(i);
+    set_bit(i);
+    return {iterator{words_, i}, inserted};
+  }
+
+  std::pair<iterator, bool> insert(iterator, enum_type e) noexcept {
+    return insert(e);
+  }
+
+  template <class FwIter>
+  auto insert(FwIter i1, FwIter i2)
+  noexcept(noexcept(++i1) && noexcept(*i1) && noexcept(i1 == i2))
+  -> typename convertible<decltype(*i1), void>::type {
+    for (; i1 != i2; ++i1) { set_bit(index_of(*i1)); }
+  }
+
+  template <class Container>
+  auto insert(const Container &ctn) noexcept
+  -> decltype(std::begin(ctn), std::end(ctn), void()) {
+    insert(std::begin(ctn), std::end(ctn));
+  }
+
+
+  iterator erase(iterator i) noexcept {
+    words_[i.index_ / detail::word_bits] &= ~bit_of(i.index_);
+    return ++i;
+  }
+
+  size_type erase(enum_type e) noexcept {
+    const std::size_t i = index_of(e);
+    const size_type e_count = test_bit(i) ? 1 : 0;
+    words_[i / detail::word_bits] &= ~bit_of(i);
+    return e_count;
+  }
+
+  iterator erase(iterator i1, iterator i2) noexcept {
+    word_type range[detail::word_count(Bits)] = {};
+    for (std::size_t w = 0; w < word_count(); ++w) {
+      const std::size_t first = w * detail::word_bits;
+      const std::size_t last = first + detail::word_bits;
+      if (i1.index_ >= last || i2.index_ <= first) { continue; }
+      word_type mask = ~word_type{0};
+      if (i1.index_ > first) { mask &= ~word_type{0} << (i1.index_ - first); }
+      if (i2.index_ < last) { mask &= bit_of(i2.index_ - first) - 1; }
+      range[w] = mask;
+    }
+    detail::transform_elements<detail::andnot_op>(words_, range,
+                                                  word_count());
+    return i2;
+  }
+
+
+  void clear() noexcept {
+    for (auto &word : words_) { word = 0; }
+  }
+
+private:
+  // Every enumerator must be a bit index below Bits: words_ has no room
+  // for any other.
+  static std::size_t index_of(enum_type e) noexcept {
+    assert(static_cast<std::size_t>(e) < Bits
+           && "flags::wide_flags: enumerator out of range");
+    return static_cast<std::size_t>(e);
+  }
+
+  static word_type bit_of(std::size_t i) noexcept {
+    return word_type{1} << (i % detail::word_bits);
+  }
+
+  bool test_bit(std::size_t i) const noexcept {
+    return (words_[i / detail::word_bits] & bit_of(i)) != 0;
+  }
+
+  void set_bit(std::size_t i) noexcept {
+    words_[i / detail::word_bits] |= bit_of(i);
+  }
+
+  // Keeps bits past Bits in the last word zero.
+  void trim() noexcept {
+    if (Bits % detail::word_bits) {
+      words_[word_count() - 1] &= bit_of(Bits) - 1;
+    }
+  }
+
+  word_type words_[detail::word_count(Bits)];
+};
+
+
+template <class E, std::size_t Bits>
+void swap(wide_flags<E, Bits> &fl1, wide_flags<E, Bits> &fl2) noexcept {
+  fl1.swap(fl2);
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_WIDE_FLAGS_HPP
@@ -0,0 +1,468 @@
+#ifndef ENUM_CLASS_WIRE_HPP
+#define ENUM_CLASS_WIRE_HPP
+
+
+#include "allow_flags.hpp"
+#include "bits.hpp"
+#include "flags.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) \
+    || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+#  define ENUM_CLASS_FLAGS_LITTLE_ENDIAN
+#endif
+
+
+namespace flags {
+
+
+enum class wire_option : unsigned char {
+  // every value is written as its difference (XOR) to the previous one,
+  // as the list of the bits that changed when there are few of them
+  delta = 1,
+  // runs of equal consecutive values are written once, with their length
+  run_length = 2
+};
+
+
+} // namespace flags
+
+
+ALLOW_FLAGS_FOR_ENUM_VALUES(::flags::wire_option, delta, run_length)
+
+
+namespace flags {
+
+
+// A compact binary encoding of sequences of flags<E>. Each value takes only
+// as many bits as the highest flag of E needs (wire_width), so that e.g. a
+// 5-flag enum costs 5 bits per value whatever its underlying type.
+//
+// Stream layout:
+//   byte 0   wire_option bits in bits 0-1, wire width - 1 in bits 2-7
+//   then     number of values, unsigned LEB128
+//   then     bit stream, least significant bit of each byte first, padded
+//            with zeros to a whole byte
+//
+// In the bit stream every value is written as its width raw bits. With
+// delta, the XOR d with the previous value (zero for the first one) is
+// written instead as gamma(popcount(d) + 1) followed, if d is sparse enough
+// to save space, by the index of each changed bit, and otherwise by the
+// width raw bits of d. With run_length, a run of equal values is written as
+// one value followed by gamma(length of the run). delta pays off for wide
+// values where few bits change at a time; a change costs at least
+// 3 + log2(width) bits.
+//
+// gamma(x) is the Elias gamma code of x >= 1: floor(log2(x)) zero bits,
+// a one bit, then the floor(log2(x)) low bits of x.
+
+using wire_options = flags<wire_option>;
+
+
+struct encode_result {
+  unsigned char *ptr;
+  std::errc ec;
+};
+
+struct decode_result {
+  const unsigned char *ptr;
+  // number of values in the stream
+  std::size_t count;
+  std::errc ec;
+};
+
+
+// Bits per value on the wire: those up to the highest flag of E, which is
+// the full width of the underlying type unless E is allowed with
+// ALLOW_FLAGS_FOR_ENUM_VALUES.
+template <class E> constexpr unsigned wire_width() noexcept {
+  return enum_mask<E>::value
+         ? static_cast<unsigned>(detail::bit_width(enum_mask<E>::value))
+         : 1u;
+}
+
+// Size of a buffer that fits n values of flags<E> encoded with any options.
+template <class E>
+constexpr std::size_t max_wire_size(std::size_t n) noexcept {
+  // 2 bits of run length per value at worst, 13 bits of changed bit count
+  return 11 + (n * (wire_width<E>() + 15) + 7) / 8;
+}
+
+
+namespace detail {
+
+
+constexpr std::uint64_t low_bits(unsigned n) noexcept {
+  return n >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+}
+
+// Bits needed to index a bit of a value of the given wire width.
+constexpr unsigned index_bits(unsigned width) noexcept {
+  return static_cast<unsigned>(bit_width(width - 1u));
+}
+
+// Whether a delta with changed bits is written as bit indices.
+constexpr bool sparse_delta(unsigned changed, unsigned width) noexcept {
+  return changed * index_bits(width) < width;
+}
+
+
+inline std::uint64_t load_le(const unsigned char *p) noexcept {
+  std::uint64_t v = 0;
+#ifdef ENUM_CLASS_FLAGS_LITTLE_ENDIAN
+  std::memcpy(&v, p, 8);
+#else
+  for (unsigned i = 0; i < 8; ++i) { v |= std::uint64_t{p[i]} << (8 * i); }
+#endif
+  return v;
+}
+
+inline void store_le(unsigned char *p, std::uint64_t v) noexcept {
+#ifdef ENUM_CLASS_FLAGS_LITTLE_ENDIAN
+  std::memcpy(p, &v, 8);
+#else
+  for (unsigned i = 0; i < 8; ++i) {
+    p[i] = static_cast<unsigned char>(v >> (8 * i));
+  }
+#endif
+}
+
+
+class bit_writer {
+public:
+  bit_writer(unsigned char *first, unsigned char *last) noexcept
+  : out_(first), last_(last) {}
+
+
+  // Appends the n <= 56 low bits of v.
+  void put(std::uint64_t v, unsigned n) noexcept {
+    acc_ |= (v & low_bits(n)) << bits_;
+    bits_ += n;
+    if (bits_ < 8) { return; }
+
+    // whole bytes of the accumulator go out with one 8-byte store
+    if (last_ - out_ >= 8) {
+      store_le(out_, acc_);
+      const unsigned bytes = bits_ / 8;
+      out_ += bytes;
+      acc_ >>= bytes * 8;
+      bits_ &= 7;
+      return;
+    }
+    for (; bits_ >= 8; bits_ -= 8, acc_ >>= 8) { emit(); }
+  }
+
+  // Appends the n <= 64 low bits of v.
+  void put_wide(std::uint64_t v, unsigned n) noexcept {
+    if (n > 32) {
+      put(v, 32);
+      v >>= 32;
+      n -= 32;
+    }
+    put(v, n);
+  }
+
+  void put_gamma(std::uint64_t x) noexcept {
+    const auto n = static_cast<unsigned>(bit_width(x)) - 1;
+    put_wide(std::uint64_t{1} << n, n + 1);
+    put_wide(x, n);
+  }
+
+  // Pads the last byte and returns the end of the written bytes, or nullptr
+  // if they did not fit.
+  unsigned char *finish() noexcept {
+    if (bits_) {
+      emit();
+      bits_ = 0;
+    }
+    return overflow_ ? nullptr : out_;
+  }
+
+private:
+  void emit() noexcept {
+    if (out_ == last_) {
+      overflow_ = true;
+      return;
+    }
+    *out_++ = static_cast<unsigned char>(acc_ & 0xff);
+  }
+
+
+  unsigned char *out_;
+  unsigned char *last_;
+  std::uint64_t acc_ = 0;
+  unsigned bits_ = 0;
+  bool overflow_ = false;
+};
+
+
+class bit_reader {
+public:
+  bit_reader(const unsigned char *first, const unsigned char *last) noexcept
+  : in_(first), last_(last) {}
+
+
+  // Reads n <= 56 bits.
+  std::uint64_t get(unsigned n) noexcept {
+    if (bits_ < n) { refill(); }
+    if (bits_ < n) {
+      failed_ = true;
+      return 0;
+    }
+    const std::uint64_t v = acc_ & low_bits(n);
+    acc_ >>= n;
+    bits_ -= n;
+    return v;
+  }
+
+  // Reads n <= 64 bits.
+  std::uint64_t get_wide(unsigned n) noexcept {
+    if (n <= 32) { return get(n); }
+    const std::uint64_t low = get(32);
+    return low | (get(n - 32) << 32);
+  }
+
+  std::uint64_t get_gamma() noexcept {
+    refill();
+    const int zeros = countr_zero(acc_);
+    if (!acc_ || static_cast<unsigned>(zeros) >= bits_) {
+      failed_ = true;
+      return 0;
+    }
+    const auto n = static_cast<unsigned>(zeros);
+    get(n + 1);
+    return (std::uint64_t{1} << n) | get_wide(n);
+  }
+
+  void fail() noexcept { failed_ = true; }
+  bool failed() const noexcept { return failed_; }
+
+  // End of the bytes consumed so far.
+  const unsigned char *position() const noexcept { return in_ - bits_ / 8; }
+
+private:
+  // Tops the accumulator up to at least 56 bits, or to the end of the
+  // input. Away from the end, this is one 8-byte load; bits of the bytes
+  // only partly taken are or-ed in again by the next refill.
+  void refill() noexcept {
+    if (bits_ > 56) { return; }
+    if (last_ - in_ >= 8) {
+      acc_ |= load_le(in_) << bits_;
+      in_ += (63 - bits_) / 8;
+      bits_ |= 56;
+      return;
+    }
+    for (; bits_ <= 56 && in_ != last_; bits_ += 8) {
+      acc_ |= std::uint64_t{*in_++} << bits_;
+    }
+  }
+
+
+  const unsigned char *in_;
+  const unsigned char *last_;
+  std::uint64_t acc_ = 0;
+  unsigned bits_ = 0;
+  bool failed_ = false;
+};
+
+
+inline void put_delta(bit_writer &w, std::uint64_t d,
+                      unsigned width) noexcept {
+  const auto changed = static_cast<unsigned>(popcount(d));
+  w.put_gamma(changed + 1);
+  if (!changed) { return; }
+  if (sparse_delta(changed, width)) {
+    for (; d; d = clear_lowest_bit(d)) {
+      w.put(static_cast<std::uint64_t>(countr_zero(d)), index_bits(width));
+    }
+  } else {
+    w.put_wide(d, width);
+  }
+}
+
+inline std::uint64_t get_delta(bit_reader &r, unsigned width) noexcept {
+  const std::uint64_t changed = r.get_gamma() - 1;
+  if (changed > width) {
+    r.fail();
+    return 0;
+  }
+  if (!changed) { return 0; }
+  if (!sparse_delta(static_cast<unsigned>(changed), width)) {
+    return r.get_wide(width);
+  }
+
+  std::uint64_t d = 0;
+  for (std::uint64_t i = 0; i < changed; ++i) {
+    const std::uint64_t bit = r.get(index_bits(width));
+    if (bit >= width) {
+      r.fail();
+      return 0;
+    }
+    d |= std::uint64_t{1} << bit;
+  }
+  return d;
+}
+
+
+// Decodes count values of width bits without delta or run_length. Unlike
+// bit_reader, every value is extracted with its own load and shift, so that
+// the loop carries no dependency from one value to the next.
+template <class E>
+decode_result unpack_fixed(const unsigned char *first,
+                           const unsigned char *last, flags<E> *out,
+                           std::size_t count, unsigned width) noexcept {
+  using underlying_type = typename flags<E>::underlying_type;
+  const std::size_t size = (count * width + 7) / 8;
+  if (static_cast<std::size_t>(last - first) < size) {
+    return {first, 0, std::errc::invalid_argument};
+  }
+
+  std::size_t i = 0;
+  if (width <= 56 && size >= 8) {
+    // values whose 8-byte load stays within the stream
+    std::size_t loads = ((size - 8) * 8 + 7) / width + 1;
+    loads = loads < count ? loads : count;
+    const std::uint64_t mask = low_bits(width);
+    for (; i < loads; ++i) {
+      const std::size_t bit = i * width;
+      const std::uint64_t v = load_le(first + bit / 8) >> (bit % 8);
+      out[i].set_underlying_value(static_cast<underlying_type>(v & mask));
+    }
+  }
+
+  bit_reader r{first + (i * width) / 8, first + size};
+  r.get(static_cast<unsigned>((i * width) % 8));
+  for (; i < count; ++i) {
+    out[i].set_underlying_value(
+      static_cast<underlying_type>(r.get_wide(width)));
+  }
+  return {first + size, count, {}};
+}
+
+
+} // namespace detail
+
+
+// Encodes values[0], ..., values[n - 1] to [first, last). On success
+// returns the end of the encoded bytes; when they do not fit, returns
+// {last, std::errc::value_too_large}. max_wire_size<E>(n) bytes always
+// suffice. A value with bits that name no enumerator of E, such as one
+// given by set_underlying_value, has no encoding: the result is then
+// {first, std::errc::invalid_argument}.
+template <class E>
+encode_result encode_wire(const flags<E> *values, std::size_t n,
+                          unsigned char *first, unsigned char *last,
+                          wire_options options = wire_options{empty_t{}})
+noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  const encode_result too_large{last, std::errc::value_too_large};
+  const encode_result invalid{first, std::errc::invalid_argument};
+  constexpr unsigned width = wire_width<E>();
+  constexpr impl_type mask = enum_mask<E>::value;
+  const bool delta = options.count(wire_option::delta) != 0;
+  const bool run_length = options.count(wire_option::run_length) != 0;
+
+  if (first == last) { return too_large; }
+  *first++ = static_cast<unsigned char>(options.underlying_value()
+                                        | ((width - 1) << 2));
+  for (std::size_t count = n;; count >>= 7) {
+    if (first == last) { return too_large; }
+    *first++ = static_cast<unsigned char>((count & 0x7f)
+                                          | (count > 0x7f ? 0x80 : 0));
+    if (count <= 0x7f) { break; }
+  }
+
+  detail::bit_writer w{first, last};
+  impl_type previous = 0;
+  for (std::size_t i = 0; i < n;) {
+    const auto value = static_cast<impl_type>(values[i].underlying_value());
+    if (value & static_cast<impl_type>(~mask)) { return invalid; }
+    std::size_t run = 1;
+    if (run_length) {
+      while (i + run < n
+             && static_cast<impl_type>(values[i + run].underlying_value())
+                == value) {
+        ++run;
+      }
+    }
+
+    if (delta) {
+      detail::put_delta(w, static_cast<impl_type>(value ^ previous), width);
+    } else {
+      w.put_wide(value, width);
+    }
+    if (run_length) { w.put_gamma(run); }
+
+    previous = value;
+    i += run;
+  }
+
+  unsigned char *end = w.finish();
+  return end ? encode_result{end, {}} : too_large;
+}
+
+
+// Decodes a stream written by encode_wire into out[0], out[1], ... On
+// success count is the number of values written. If the stream holds more
+// than capacity values, nothing is decoded and the error is
+// std::errc::value_too_large, with count giving the capacity needed; a
+// malformed or truncated stream is std::errc::invalid_argument.
+template <class E>
+decode_result decode_wire(const unsigned char *first,
+                          const unsigned char *last, flags<E> *out,
+                          std::size_t capacity) noexcept {
+  using impl_type = typename flags<E>::impl_type;
+  using underlying_type = typename flags<E>::underlying_type;
+  const decode_result invalid{first, 0, std::errc::invalid_argument};
+
+  if (first == last) { return invalid; }
+  const unsigned header = *first++;
+  const unsigned width = (header >> 2) + 1;
+  const bool delta = header & static_cast<unsigned>(wire_option::delta);
+  const bool run_length =
+    header & static_cast<unsigned>(wire_option::run_length);
+  if (width > sizeof(impl_type) * 8) { return invalid; }
+
+  std::size_t count = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    if (first == last || shift >= sizeof(std::size_t) * 8) { return invalid; }
+    const unsigned byte = *first++;
+    count |= static_cast<std::size_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) { break; }
+  }
+  if (count > capacity) {
+    return {first, count, std::errc::value_too_large};
+  }
+
+  if (!delta && !run_length) {
+    return detail::unpack_fixed(first, last, out, count, width);
+  }
+
+  detail::bit_reader r{first, last};
+  impl_type previous = 0;
+  for (std::size_t i = 0; i < count;) {
+    const auto value = static_cast<impl_type>(
+      delta ? previous ^ detail::get_delta(r, width) : r.get_wide(width));
+    const std::uint64_t run = run_length ? r.get_gamma() : 1;
+    if (r.failed() || run > count - i) {
+      return {r.position(), i, std::errc::invalid_argument};
+    }
+
+    for (const std::size_t end = i + run; i < end; ++i) {
+      out[i].set_underlying_value(static_cast<underlying_type>(value));
+    }
+    previous = value;
+  }
+  return {r.position(), count, {}};
+}
+
+
+} // namespace flags
+
+
+#endif // ENUM_CLASS_WIRE_HPP
@@ -0,0 +1,112 @@
+#include "common.hpp"
+
+#include <flags/atomic_flags.hpp>
+
+#include <thread>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+namespace flags {
+template <class E>
+auto operator<<(std::ostream& o, flags<E> fl) -> std::ostream& {
+  return o << "flags<" << fl.underlying_value() << '>';
+}
+} // namespace flags
+
+
+void test_fetch_operations() {
+  flags::atomic_flags<Enum> fl{Enum::One};
+  BOOST_TEST(fl.is_lock_free());
+  BOOST_TEST_EQ(fl.load(), Enums{Enum::One});
+
+  BOOST_TEST_EQ(fl.fetch_insert(Enum::Two | Enum::Four), Enums{Enum::One});
+  BOOST_TEST_EQ(fl.load(std::memory_order_acquire),
+                Enum::One | Enum::Two | Enum::Four);
+
+  BOOST_TEST_EQ(fl.fetch_erase(Enum::One, std::memory_order_acq_rel),
+                Enum::One | Enum::Two | Enum::Four);
+  BOOST_TEST_EQ(fl.fetch_toggle(Enum::Four | Enum::Eight),
+                Enum::Two | Enum::Four);
+  BOOST_TEST_EQ(static_cast<Enums>(fl), Enum::Two | Enum::Eight);
+
+  BOOST_TEST_EQ(fl.exchange(Enums{flags::empty}), Enum::Two | Enum::Eight);
+  fl = Enum::Eight;
+  fl.store(fl.load() | Enum::One, std::memory_order_release);
+  BOOST_TEST_EQ(fl.load(), Enum::One | Enum::Eight);
+}
+
+
+void test_test_and_set() {
+  flags::atomic_flags<SmallEnum> fl;
+  BOOST_TEST(fl.test_and_insert(SmallEnum::SmallTwo));
+  BOOST_TEST_NOT(fl.test_and_insert(SmallEnum::SmallTwo));
+  BOOST_TEST(fl.test_and_erase(SmallEnum::SmallTwo));
+  BOOST_TEST_NOT(fl.test_and_erase(SmallEnum::SmallTwo));
+  BOOST_TEST(fl.load().empty());
+}
+
+
+void test_compare_exchange() {
+  flags::atomic_flags<Enum> fl{Enum::One};
+
+  Enums expected = Enum::Two;
+  BOOST_TEST_NOT(fl.compare_exchange_strong(expected, Enum::Four));
+  BOOST_TEST_EQ(expected, Enums{Enum::One});
+
+  BOOST_TEST(fl.compare_exchange_strong(expected, Enum::Four,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire));
+  BOOST_TEST_EQ(fl.load(), Enums{Enum::Four});
+
+  while (!fl.compare_exchange_weak(expected, expected | Enum::Eight)) {}
+  BOOST_TEST_EQ(fl.load(), Enum::Four | Enum::Eight);
+}
+
+
+void test_concurrent_insert() {
+  flags::atomic_flags<Enum> fl;
+  const Enum all[] = {Enum::One, Enum::Two, Enum::Four, Enum::Eight};
+  std::atomic<int> winners{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t) {
+    threads.emplace_back([&] {
+      for (const auto e : all) {
+        if (fl.test_and_insert(e, std::memory_order_relaxed)) ++winners;
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  BOOST_TEST_EQ(4, winners.load());
+  BOOST_TEST_EQ(4u, fl.load().size());
+}
+
+
+#ifdef __cpp_lib_atomic_wait
+void test_wait() {
+  flags::atomic_flags<Enum> fl;
+  std::thread setter([&] {
+    fl.fetch_insert(Enum::Two);
+    fl.notify_one();
+  });
+  fl.wait(Enums{flags::empty});
+  setter.join();
+  BOOST_TEST_EQ(fl.load(), Enums{Enum::Two});
+}
+#endif
+
+
+int main() {
+  static_assert(flags::atomic_flags<Enum>::is_always_lock_free, "");
+  test_fetch_operations();
+  test_test_and_set();
+  test_compare_exchange();
+  test_concurrent_insert();
+#ifdef __cpp_lib_atomic_wait
+  test_wait();
+#endif
+  return boost::report_errors();
+}
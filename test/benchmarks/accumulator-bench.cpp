@@ -0,0 +1,73 @@
+#include "bench.hpp"
+
+#include <flags/atomic_flags.hpp>
+#include <flags/flags_accumulator.hpp>
+#include <flags/parallel.hpp>
+
+#include <mutex>
+#include <string>
+
+
+namespace {
+
+
+constexpr std::size_t reports = 1 << 16;
+
+
+// Every thread reports one of a few flags over and over, as error and
+// capability flags are.
+template <class E, class Report>
+void run_reports(bench::session &s, flags::thread_pool &pool,
+                 const char *impl, Report report) {
+  const std::size_t threads = pool.concurrency();
+  s.run(bench::case_id{"report_flags", bench::width<E>(),
+                       std::to_string(threads) + "_threads", impl},
+        reports * threads, [] { return 0; },
+        [&](int &) {
+          pool.parallel_for(threads, [&](std::size_t t) {
+            for (std::size_t i = 0; i < reports; ++i) {
+              report(bench::nth_flag<E>(static_cast<unsigned>((t + i) % 4)));
+            }
+          });
+        });
+}
+
+
+template <class E> void run_width(bench::session &s) {
+  using flags_type = flags::flags<E>;
+  const std::size_t cores = flags::thread_pool::default_concurrency();
+  for (std::size_t threads = 1; ; threads *= 2) {
+    if (threads > cores) { threads = cores; }
+    flags::thread_pool pool(threads);
+
+    std::mutex mutex;
+    flags_type locked{flags::empty};
+    run_reports<E>(s, pool, "std::mutex", [&](E e) {
+      std::lock_guard<std::mutex> lock(mutex);
+      locked |= e;
+    });
+    bench::do_not_optimize(locked);
+
+    flags::atomic_flags<E> shared;
+    run_reports<E>(s, pool, "std::atomic", [&](E e) {
+      shared.fetch_insert(e, std::memory_order_relaxed);
+    });
+
+    flags::flags_accumulator<E> acc(threads);
+    run_reports<E>(s, pool, "flags_accumulator", [&](E e) {
+      acc |= e;
+    });
+    bench::do_not_optimize(acc.united());
+
+    if (threads == cores) { break; }
+  }
+}
+
+
+void accumulator_operations(bench::session &s) {
+  run_width<bench::E32>(s);
+}
+BENCHMARK(accumulator_operations)
+
+
+} // namespace
@@ -0,0 +1,164 @@
+#ifndef ENUM_CLASS_TEST_BENCH_HPP
+#define ENUM_CLASS_TEST_BENCH_HPP
+
+
+#include <flags/flags.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace bench {
+
+
+// Keeps the optimizer from discarding a value or hoisting work out of a loop.
+template <class T> inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+
+struct case_id {
+  std::string name;
+  unsigned width;
+  std::string density;
+  std::string impl;
+};
+
+
+// Runs timed cases and writes one CSV row per case, so that results of two
+// releases can be compared with ordinary text tools.
+class session {
+public:
+  explicit session(std::ostream &out, std::size_t samples = 101)
+  : out_(out), samples_(samples) {
+    out_ << "benchmark,width,density,impl,ns_per_op\n";
+  }
+
+  // Calls setup() before every sample and times body(state), which is
+  // expected to perform ops operations.
+  template <class Setup, class Body>
+  void run(const case_id &id, std::size_t ops, Setup setup, Body body) {
+    std::vector<double> timings;
+    timings.reserve(samples_);
+    for (std::size_t i = 0; i <= samples_; ++i) {
+      auto state = setup();
+      const auto start = clock::now();
+      body(state);
+      const auto stop = clock::now();
+      do_not_optimize(state);
+      // the first sample only warms up caches
+      if (i) {
+        std::chrono::duration<double, std::nano> elapsed = stop - start;
+        timings.push_back(elapsed.count() / static_cast<double>(ops));
+      }
+    }
+    auto median = timings.begin() + timings.size() / 2;
+    std::nth_element(timings.begin(), median, timings.end());
+    out_ << id.name << ',' << id.width << ',' << id.density << ','
+         << id.impl << ',' << *median << '\n';
+  }
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  std::ostream &out_;
+  std::size_t samples_;
+};
+
+
+using bench_function = void (*)(session &);
+
+inline std::vector<std::pair<const char *, bench_function>> &registry() {
+  static std::vector<std::pair<const char *, bench_function>> functions;
+  return functions;
+}
+
+struct registrar {
+  registrar(const char *name, bench_function f) {
+    registry().emplace_back(name, f);
+  }
+};
+
+
+// Enums used throughout the suite, one per supported impl_type width.
+enum class E8 : std::uint8_t {};
+enum class E16 : std::uint16_t {};
+enum class E32 : std::uint32_t {};
+enum class E64 : std::uint64_t {};
+
+
+template <class E>
+constexpr unsigned width() {
+  return static_cast<unsigned>(sizeof(E) * 8);
+}
+
+template <class E>
+E nth_flag(unsigned n) {
+  using impl = typename std::make_unsigned<
+    typename std::underlying_type<E>::type>::type;
+  return static_cast<E>(static_cast<impl>(impl{1} << n));
+}
+
+
+enum class density { sparse, dense };
+
+inline const char *to_string(density d) {
+  return d == density::sparse ? "sparse" : "dense";
+}
+
+// Each value is given as the list of its flags. Sparse values have two flags
+// set, dense values have every flag set but one.
+template <class E>
+std::vector<std::vector<E>> make_values(density d, std::size_t count) {
+  std::mt19937 gen(static_cast<std::mt19937::result_type>(width<E>()));
+  std::uniform_int_distribution<unsigned> bit(0, width<E>() - 1);
+
+  std::vector<std::vector<E>> result(count);
+  for (auto &value : result) {
+    if (d == density::sparse) {
+      const unsigned a = bit(gen);
+      unsigned b;
+      do { b = bit(gen); } while (b == a);
+      value = {nth_flag<E>(std::min(a, b)), nth_flag<E>(std::max(a, b))};
+    } else {
+      const unsigned hole = bit(gen);
+      for (unsigned n = 0; n < width<E>(); ++n) {
+        if (n != hole) { value.push_back(nth_flag<E>(n)); }
+      }
+    }
+  }
+  return result;
+}
+
+
+} // namespace bench
+
+
+ALLOW_FLAGS_FOR_ENUM(bench::E8)
+ALLOW_FLAGS_FOR_ENUM(bench::E16)
+ALLOW_FLAGS_FOR_ENUM(bench::E32)
+ALLOW_FLAGS_FOR_ENUM(bench::E64)
+
+
+#define ENUM_CLASS_BENCH_CAT_IMPL(a, b) a ## b
+#define ENUM_CLASS_BENCH_CAT(a, b) ENUM_CLASS_BENCH_CAT_IMPL(a, b)
+
+// Registers void f(bench::session &) to be run by the bench executable.
+#define BENCHMARK(f) \
+static const ::bench::registrar ENUM_CLASS_BENCH_CAT(bench_registrar_, \
+                                                     __LINE__)(#f, f);
+
+
+#endif // ENUM_CLASS_TEST_BENCH_HPP
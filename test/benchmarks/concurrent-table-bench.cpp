@@ -0,0 +1,106 @@
+#include "bench.hpp"
+
+#include <flags/concurrent_flags_table.hpp>
+#include <flags/parallel.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace {
+
+
+constexpr std::size_t sessions = 1 << 16;
+constexpr std::size_t operations = 1 << 16;
+
+
+// Every thread runs operations operations on random sessions: eight tests
+// for one insertion and one erasure.
+template <class E, class Table>
+void run_updates(bench::session &s, flags::thread_pool &pool,
+                 const char *impl, Table &table) {
+  const std::size_t threads = pool.concurrency();
+  s.run(bench::case_id{"session_flags", bench::width<E>(),
+                       std::to_string(threads) + "_threads", impl},
+        operations * threads, [] { return std::size_t{0}; },
+        [&](std::size_t &hits) {
+          std::atomic<std::size_t> total(0);
+          pool.parallel_for(threads, [&](std::size_t t) {
+            std::uint64_t x = t * 0x9e3779b97f4a7c15u + 1;
+            std::size_t found = 0;
+            for (std::size_t i = 0; i < operations; ++i) {
+              x ^= x << 13;
+              x ^= x >> 7;
+              x ^= x << 17;
+              const std::uint64_t key = x % sessions;
+              const E e = bench::nth_flag<E>(static_cast<unsigned>(x >> 60));
+              switch (i % 10) {
+              case 0: table.insert(key, e); break;
+              case 1: table.erase(key, e); break;
+              default: found += table.test(key, e) ? 1 : 0;
+              }
+            }
+            total += found;
+          });
+          hits = total;
+        });
+}
+
+
+template <class E> struct locked_map {
+  void insert(std::uint64_t key, E e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    map[key] |= e;
+  }
+  void erase(std::uint64_t key, E e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    map[key] &= ~flags::flags<E>{e};
+  }
+  bool test(std::uint64_t key, E e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = map.find(key);
+    return it != map.end() && it->second.all_of(flags::flags<E>{e});
+  }
+
+  std::mutex mutex;
+  std::unordered_map<std::uint64_t, flags::flags<E>> map;
+};
+
+template <class E> struct lock_free_table {
+  void insert(std::uint64_t key, E e) { table.insert_flags(key, e); }
+  void erase(std::uint64_t key, E e) { table.erase_flags(key, e); }
+  bool test(std::uint64_t key, E e) const { return table.test(key, e); }
+
+  flags::concurrent_flags_table<std::uint64_t, E> table{2 * sessions};
+};
+
+
+template <class E> void run_width(bench::session &s) {
+  const std::size_t cores = flags::thread_pool::default_concurrency();
+  for (std::size_t threads = 1; ; threads *= 2) {
+    if (threads > cores) { threads = cores; }
+    flags::thread_pool pool(threads);
+
+    locked_map<E> locked;
+    lock_free_table<E> lock_free;
+    for (std::uint64_t key = 0; key < sessions; ++key) {
+      locked.map[key] = flags::flags<E>{flags::empty};
+      lock_free.table.insert_flags(key, flags::flags<E>{flags::empty});
+    }
+    run_updates<E>(s, pool, "std::unordered_map+std::mutex", locked);
+    run_updates<E>(s, pool, "concurrent_flags_table", lock_free);
+
+    if (threads == cores) { break; }
+  }
+}
+
+
+void concurrent_table_operations(bench::session &s) {
+  run_width<bench::E16>(s);
+}
+BENCHMARK(concurrent_table_operations)
+
+
+} // namespace
@@ -0,0 +1,345 @@
+#include "bench.hpp"
+
+#include <bitset>
+#include <iterator>
+#include <set>
+
+
+namespace {
+
+
+using bench::density;
+using bench::width;
+
+
+template <class E>
+using impl_type = typename flags::flags<E>::impl_type;
+
+template <class E>
+unsigned index_of(E e) {
+  auto x = static_cast<impl_type<E>>(e);
+  unsigned n = 0;
+  while (!(x & 1)) {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+}
+
+
+// Each model wraps one representation of a set of flags behind the same
+// static interface, so that every case runs unchanged against all of them.
+
+template <class E> struct flags_model {
+  using value_type = flags::flags<E>;
+  static const char *name() { return "flags"; }
+
+  static value_type make(const std::vector<E> &es) {
+    return value_type(es.begin(), es.end());
+  }
+  static value_type from_list(std::initializer_list<E> il) {
+    return value_type(il);
+  }
+  static void insert(value_type &v, const std::vector<E> &es) {
+    v.insert(es.begin(), es.end());
+  }
+  static std::uint64_t iterate(const value_type &v) {
+    std::uint64_t sum = 0;
+    for (auto e : v) { sum += static_cast<impl_type<E>>(e); }
+    return sum;
+  }
+  static bool contains(const value_type &v, E e) {
+    return v.find(e) != v.end();
+  }
+  static std::size_t size(const value_type &v) { return v.size(); }
+  static void erase_front(value_type &v, std::size_t n) {
+    v.erase(v.begin(), std::next(v.begin(), n));
+  }
+  static value_type bit_or(const value_type &a, const value_type &b) {
+    return a | b;
+  }
+  static value_type bit_and(const value_type &a, const value_type &b) {
+    return a & b;
+  }
+  static value_type bit_xor(const value_type &a, const value_type &b) {
+    return a ^ b;
+  }
+  static value_type bit_not(const value_type &a) { return ~a; }
+};
+
+
+template <class E> struct raw_model {
+  using value_type = impl_type<E>;
+  static const char *name() { return "raw"; }
+
+  static value_type make(const std::vector<E> &es) {
+    value_type v = 0;
+    for (auto e : es) { v |= static_cast<value_type>(e); }
+    return v;
+  }
+  static value_type from_list(std::initializer_list<E> il) {
+    value_type v = 0;
+    for (auto e : il) { v |= static_cast<value_type>(e); }
+    return v;
+  }
+  static void insert(value_type &v, const std::vector<E> &es) {
+    for (auto e : es) { v |= static_cast<value_type>(e); }
+  }
+  static std::uint64_t iterate(value_type v) {
+    std::uint64_t sum = 0;
+    while (v) {
+      sum += static_cast<value_type>(v & (~v + 1));
+      v &= v - 1;
+    }
+    return sum;
+  }
+  static bool contains(value_type v, E e) {
+    return (v & static_cast<value_type>(e)) != 0;
+  }
+  static std::size_t size(value_type v) {
+    return std::bitset<width<E>()>(v).count();
+  }
+  static void erase_front(value_type &v, std::size_t n) {
+    for (; n; --n) { v &= v - 1; }
+  }
+  static value_type bit_or(value_type a, value_type b) { return a | b; }
+  static value_type bit_and(value_type a, value_type b) { return a & b; }
+  static value_type bit_xor(value_type a, value_type b) { return a ^ b; }
+  static value_type bit_not(value_type a) { return ~a; }
+};
+
+
+template <class E> struct bitset_model {
+  using value_type = std::bitset<width<E>()>;
+  static const char *name() { return "bitset"; }
+
+  static value_type make(const std::vector<E> &es) {
+    value_type v;
+    insert(v, es);
+    return v;
+  }
+  static value_type from_list(std::initializer_list<E> il) {
+    value_type v;
+    for (auto e : il) { v.set(index_of(e)); }
+    return v;
+  }
+  static void insert(value_type &v, const std::vector<E> &es) {
+    for (auto e : es) { v.set(index_of(e)); }
+  }
+  static std::uint64_t iterate(const value_type &v) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+      if (v.test(i)) { sum += i; }
+    }
+    return sum;
+  }
+  static bool contains(const value_type &v, E e) {
+    return v.test(index_of(e));
+  }
+  static std::size_t size(const value_type &v) { return v.count(); }
+  static void erase_front(value_type &v, std::size_t n) {
+    for (std::size_t i = 0; n && i < v.size(); ++i) {
+      if (v.test(i)) {
+        v.reset(i);
+        --n;
+      }
+    }
+  }
+  static value_type bit_or(const value_type &a, const value_type &b) {
+    return a | b;
+  }
+  static value_type bit_and(const value_type &a, const value_type &b) {
+    return a & b;
+  }
+  static value_type bit_xor(const value_type &a, const value_type &b) {
+    return a ^ b;
+  }
+  static value_type bit_not(const value_type &a) { return ~a; }
+};
+
+
+template <class E> struct set_model {
+  using value_type = std::set<E>;
+  static const char *name() { return "std_set"; }
+
+  static value_type make(const std::vector<E> &es) {
+    return value_type(es.begin(), es.end());
+  }
+  static value_type from_list(std::initializer_list<E> il) {
+    return value_type(il);
+  }
+  static void insert(value_type &v, const std::vector<E> &es) {
+    v.insert(es.begin(), es.end());
+  }
+  static std::uint64_t iterate(const value_type &v) {
+    std::uint64_t sum = 0;
+    for (auto e : v) { sum += static_cast<impl_type<E>>(e); }
+    return sum;
+  }
+  static bool contains(const value_type &v, E e) {
+    return v.find(e) != v.end();
+  }
+  static std::size_t size(const value_type &v) { return v.size(); }
+  static void erase_front(value_type &v, std::size_t n) {
+    v.erase(v.begin(), std::next(v.begin(), n));
+  }
+  static value_type bit_or(const value_type &a, const value_type &b) {
+    value_type r;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                   std::inserter(r, r.end()));
+    return r;
+  }
+  static value_type bit_and(const value_type &a, const value_type &b) {
+    value_type r;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::inserter(r, r.end()));
+    return r;
+  }
+  static value_type bit_xor(const value_type &a, const value_type &b) {
+    value_type r;
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(),
+                                  std::inserter(r, r.end()));
+    return r;
+  }
+  static value_type bit_not(const value_type &a) {
+    value_type r;
+    for (unsigned n = 0; n < width<E>(); ++n) {
+      const auto e = bench::nth_flag<E>(n);
+      if (!a.count(e)) { r.insert(r.end(), e); }
+    }
+    return r;
+  }
+};
+
+
+constexpr std::size_t batch = 1024;
+
+
+template <class Model, class E>
+void run_model(bench::session &s, density d) {
+  using value_type = typename Model::value_type;
+
+  const auto lists = bench::make_values<E>(d, batch);
+  std::vector<value_type> values;
+  std::vector<E> probes;
+  for (const auto &es : lists) {
+    values.push_back(Model::make(es));
+    probes.push_back(es[es.size() / 2]);
+  }
+
+  auto id = [&](const char *name) {
+    return bench::case_id{name, width<E>(), bench::to_string(d), Model::name()};
+  };
+  auto no_state = [] { return std::uint64_t{0}; };
+  auto copy_values = [&] { return values; };
+  auto empty_results = [] { return std::vector<value_type>(batch); };
+
+  s.run(id("construct_il"), batch, empty_results,
+        [&](std::vector<value_type> &out) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            const auto &es = lists[i];
+            out[i] = Model::from_list(
+              {es.front(), es[es.size() / 2], es[es.size() / 3], es.back()});
+          }
+        });
+
+  s.run(id("insert_range"), batch, empty_results,
+        [&](std::vector<value_type> &out) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            Model::insert(out[i], lists[i]);
+          }
+        });
+
+  s.run(id("iterate"), batch, no_state, [&](std::uint64_t &acc) {
+    for (const auto &v : values) { acc += Model::iterate(v); }
+  });
+
+  s.run(id("find"), batch, no_state, [&](std::uint64_t &acc) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      acc += Model::contains(values[i], probes[(i * 7) % batch]);
+    }
+  });
+
+  s.run(id("size"), batch, no_state, [&](std::uint64_t &acc) {
+    for (const auto &v : values) { acc += Model::size(v); }
+  });
+
+  s.run(id("erase_range"), batch, copy_values,
+        [&](std::vector<value_type> &vs) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            Model::erase_front(vs[i], lists[i].size() / 2);
+          }
+        });
+
+  s.run(id("bit_or"), batch, empty_results,
+        [&](std::vector<value_type> &out) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = Model::bit_or(values[i], values[(i + 1) % batch]);
+          }
+        });
+
+  s.run(id("bit_and"), batch, empty_results,
+        [&](std::vector<value_type> &out) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = Model::bit_and(values[i], values[(i + 1) % batch]);
+          }
+        });
+
+  s.run(id("bit_xor"), batch, empty_results,
+        [&](std::vector<value_type> &out) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = Model::bit_xor(values[i], values[(i + 1) % batch]);
+          }
+        });
+
+  s.run(id("bit_not"), batch, empty_results,
+        [&](std::vector<value_type> &out) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            out[i] = Model::bit_not(values[i]);
+          }
+        });
+}
+
+
+// erase_range as flags did it before erasing a range became one mask
+// operation: by building the flags of the range element by element.
+template <class E>
+void run_erase_by_iteration(bench::session &s, density d) {
+  using value_type = flags::flags<E>;
+  const auto lists = bench::make_values<E>(d, batch);
+  std::vector<value_type> values;
+  for (const auto &es : lists) { values.emplace_back(es.begin(), es.end()); }
+
+  s.run(bench::case_id{"erase_range", width<E>(), bench::to_string(d),
+                       "flags_iteration"},
+        batch, [&] { return values; }, [&](std::vector<value_type> &vs) {
+          for (std::size_t i = 0; i < batch; ++i) {
+            const auto last = std::next(vs[i].begin(), lists[i].size() / 2);
+            vs[i] ^= value_type(vs[i].begin(), last);
+          }
+        });
+}
+
+
+template <class E>
+void run_width(bench::session &s) {
+  for (auto d : {density::sparse, density::dense}) {
+    run_model<flags_model<E>, E>(s, d);
+    run_erase_by_iteration<E>(s, d);
+    run_model<raw_model<E>, E>(s, d);
+    run_model<bitset_model<E>, E>(s, d);
+    run_model<set_model<E>, E>(s, d);
+  }
+}
+
+
+void flags_operations(bench::session &s) {
+  run_width<bench::E8>(s);
+  run_width<bench::E16>(s);
+  run_width<bench::E32>(s);
+  run_width<bench::E64>(s);
+}
+BENCHMARK(flags_operations)
+
+
+} // namespace
@@ -0,0 +1,55 @@
+#include "bench.hpp"
+
+#include <flags/histogram.hpp>
+
+#include <random>
+
+
+namespace {
+
+
+constexpr std::size_t batch = 1 << 16;
+
+
+template <class E> void run_width(bench::session &s) {
+  using flags_type = flags::flags<E>;
+  std::mt19937_64 gen(bench::width<E>());
+  std::vector<flags_type> values;
+  for (std::size_t i = 0; i < batch; ++i) {
+    flags_type fl{flags::empty};
+    fl.set_underlying_value(
+      static_cast<typename flags_type::underlying_type>(gen()));
+    values.push_back(fl);
+  }
+
+  auto id = [](const char *impl) {
+    return bench::case_id{"flag_histogram", bench::width<E>(), "random",
+                          impl};
+  };
+  using counts_type = typename flags::flag_counter<E>::counts_type;
+  auto no_state = [] { return counts_type{}; };
+
+  // what callers write without the kernel
+  s.run(id("iterator"), batch, no_state, [&](counts_type &counts) {
+    for (auto fl : values) {
+      for (auto e : fl) {
+        ++counts[static_cast<std::size_t>(flags::detail::countr_zero(
+          static_cast<typename flags_type::impl_type>(e)))];
+      }
+    }
+  });
+  s.run(id("flag_histogram"), batch, no_state, [&](counts_type &counts) {
+    counts = flags::flag_histogram(values.data(), values.size());
+  });
+}
+
+
+void histogram_operations(bench::session &s) {
+  run_width<bench::E8>(s);
+  run_width<bench::E16>(s);
+  run_width<bench::E64>(s);
+}
+BENCHMARK(histogram_operations)
+
+
+} // namespace
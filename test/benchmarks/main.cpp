@@ -0,0 +1,41 @@
+#include "bench.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+// Usage: bench [--out=FILE] [NAME...]
+// Runs the benchmarks whose names are given (all of them by default) and
+// writes the results as CSV to FILE, or to bench-results.csv.
+int main(int argc, char *argv[]) {
+  const char *out_path = "bench-results.csv";
+  std::vector<std::string> selected;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strncmp(argv[i], "--out=", 6)) {
+      out_path = argv[i] + 6;
+    } else {
+      selected.push_back(argv[i]);
+    }
+  }
+
+  std::ofstream out(out_path);
+  if (!out) {
+    std::cerr << "cannot open " << out_path << '\n';
+    return 1;
+  }
+
+  bench::session session(out);
+  for (const auto &entry : bench::registry()) {
+    if (!selected.empty()
+        && std::find(selected.begin(), selected.end(), entry.first)
+           == selected.end()) {
+      continue;
+    }
+    std::cerr << "running " << entry.first << '\n';
+    entry.second(session);
+  }
+
+  std::cerr << "results written to " << out_path << '\n';
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include "bench.hpp"
+
+#include <flags/flags_map.hpp>
+#include <flags/flags_table.hpp>
+
+#include <random>
+#include <unordered_map>
+
+
+// Twelve flags scattered over 32 bits.
+enum class Scattered : std::uint32_t {
+  F0 = 1u << 0, F1 = 1u << 3, F2 = 1u << 4, F3 = 1u << 7, F4 = 1u << 9,
+  F5 = 1u << 12, F6 = 1u << 16, F7 = 1u << 17, F8 = 1u << 21, F9 = 1u << 25,
+  F10 = 1u << 28, F11 = 1u << 30
+};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Scattered, F0, F1, F2, F3, F4, F5, F6, F7, F8,
+                            F9, F10, F11)
+
+
+namespace {
+
+
+using bench::density;
+
+
+constexpr std::size_t batch = 4096;
+
+
+// A memoization cache keyed by flag combinations: build it, then look up
+// every key once.
+template <class E, class Map>
+void run_map(bench::session &s, density d, const char *impl) {
+  using flags_type = flags::flags<E>;
+  std::vector<flags_type> keys;
+  for (const auto &es : bench::make_values<E>(d, batch)) {
+    keys.emplace_back(es.begin(), es.end());
+  }
+
+  auto id = [&](const char *name) {
+    return bench::case_id{name, bench::width<E>(), bench::to_string(d),
+                          impl};
+  };
+
+  s.run(id("map_insert"), batch, [] { return Map{}; }, [&](Map &m) {
+    for (std::size_t i = 0; i < batch; ++i) { m[keys[i]] = i; }
+  });
+
+  Map filled;
+  for (std::size_t i = 0; i < batch; ++i) { filled[keys[i]] = i; }
+  auto no_state = [] { return std::size_t{0}; };
+  s.run(id("map_find"), batch, no_state, [&](std::size_t &acc) {
+    for (const auto &key : keys) { acc += filled.find(key)->second; }
+  });
+}
+
+
+template <class E> void run_width(bench::session &s, density d) {
+  using flags_type = flags::flags<E>;
+  run_map<E, flags::flags_map<E, std::size_t>>(s, d, "flags_map");
+  run_map<E, std::unordered_map<flags_type, std::size_t>>(s, d,
+                                                          "unordered_map");
+}
+
+
+// A table of every combination of twelve flags against the maps above,
+// looking up random combinations.
+template <class Table>
+void run_lookup(bench::session &s, const char *impl) {
+  using flags_type = flags::flags<Scattered>;
+  constexpr auto mask = flags::enum_mask<Scattered>::value;
+  std::mt19937 gen(12);
+  std::vector<flags_type> keys;
+  for (std::size_t i = 0; i < batch; ++i) {
+    keys.emplace_back(static_cast<Scattered>(
+      flags::detail::deposit_bits(static_cast<std::uint32_t>(gen()), mask)));
+  }
+
+  Table table;
+  for (std::size_t i = 0; i < 4096; ++i) {
+    table[flags::flags_table<Scattered, int>::key(i)] = i;
+  }
+  auto no_state = [] { return std::size_t{0}; };
+  s.run(bench::case_id{"table_lookup", 12, "dense", impl}, batch, no_state,
+        [&](std::size_t &acc) {
+    for (const auto &key : keys) { acc += table[key]; }
+  });
+}
+
+
+void map_operations(bench::session &s) {
+  for (auto d : {density::sparse, density::dense}) {
+    run_width<bench::E16>(s, d);
+    run_width<bench::E64>(s, d);
+  }
+  run_lookup<flags::flags_table<Scattered, std::size_t>>(s, "flags_table");
+  run_lookup<flags::flags_map<Scattered, std::size_t>>(s, "flags_map");
+}
+BENCHMARK(map_operations)
+
+
+} // namespace
@@ -0,0 +1,156 @@
+#include "bench.hpp"
+
+#include <flags/names.hpp>
+#include <flags/parse.hpp>
+
+#include <map>
+#include <string>
+
+
+namespace bench {
+
+enum class Access : std::uint16_t {
+  Read = 1 << 0, Write = 1 << 1, Exec = 1 << 2, List = 1 << 3,
+  Create = 1 << 4, Delete = 1 << 5, Rename = 1 << 6, Chmod = 1 << 7,
+  Chown = 1 << 8, Link = 1 << 9, Lock = 1 << 10, Unlock = 1 << 11,
+  Append = 1 << 12, Truncate = 1 << 13, Search = 1 << 14, Admin = 1 << 15
+};
+
+} // namespace bench
+
+ALLOW_FLAGS_FOR_ENUM_VALUES(bench::Access, Read, Write, Exec, List, Create,
+                            Delete, Rename, Chmod, Chown, Link, Lock, Unlock,
+                            Append, Truncate, Search, Admin)
+
+
+namespace {
+
+
+using bench::Access;
+using bench::density;
+using Accesses = flags::flags<Access>;
+
+
+// What hand-written conversions typically look like: a std::map per
+// direction and std::string concatenation.
+struct naive_names {
+  std::map<std::string, Access> by_name;
+  std::map<Access, std::string> by_value;
+
+  naive_names() {
+    using names = flags::enum_names<Access>;
+    for (std::size_t i = 0; i < names::count; ++i) {
+      const auto &entry = names::entries[i];
+      const auto e = static_cast<Access>(entry.value);
+      by_name.emplace(std::string(entry.name, entry.length), e);
+      by_value.emplace(e, std::string(entry.name, entry.length));
+    }
+  }
+
+  std::string format(Accesses fl) const {
+    std::string result;
+    for (auto e : fl) {
+      if (!result.empty()) { result += '|'; }
+      result += by_value.at(e);
+    }
+    return result.empty() ? "0" : result;
+  }
+
+  Accesses parse(const std::string &s) const {
+    Accesses result{flags::empty};
+    std::size_t start = 0;
+    while (start <= s.size()) {
+      auto end = s.find('|', start);
+      if (end == std::string::npos) { end = s.size(); }
+      const auto i = by_name.find(s.substr(start, end - start));
+      if (i != by_name.end()) { result |= i->second; }
+      start = end + 1;
+    }
+    return result;
+  }
+};
+
+
+constexpr std::size_t batch = 1024;
+
+
+void run_density(bench::session &s, density d) {
+  const naive_names naive;
+
+  std::vector<Accesses> values;
+  std::vector<std::string> texts;
+  for (const auto &es : bench::make_values<Access>(d, batch)) {
+    values.emplace_back(es.begin(), es.end());
+    texts.push_back(naive.format(values.back()));
+  }
+
+  auto id = [&](const char *name, const char *impl) {
+    return bench::case_id{name, bench::width<Access>(), bench::to_string(d),
+                          impl};
+  };
+  auto no_state = [] { return std::uint64_t{0}; };
+
+  s.run(id("format", "to_chars"), batch, no_state, [&](std::uint64_t &acc) {
+    char buffer[flags::max_chars<Access>()];
+    for (const auto &v : values) {
+      const auto r = flags::to_chars(buffer, buffer + sizeof(buffer), v);
+      acc += static_cast<std::uint64_t>(r.ptr - buffer);
+      bench::do_not_optimize(buffer);
+    }
+  });
+
+  s.run(id("format", "std_map"), batch, no_state, [&](std::uint64_t &acc) {
+    for (const auto &v : values) { acc += naive.format(v).size(); }
+  });
+
+  s.run(id("parse", "from_chars"), batch, no_state, [&](std::uint64_t &acc) {
+    for (const auto &t : texts) {
+      Accesses fl{flags::empty};
+      flags::from_chars(t.data(), t.data() + t.size(), fl);
+      acc += static_cast<std::uint64_t>(fl.underlying_value());
+    }
+  });
+
+  s.run(id("parse", "std_map"), batch, no_state, [&](std::uint64_t &acc) {
+    for (const auto &t : texts) {
+      acc += static_cast<std::uint64_t>(naive.parse(t).underlying_value());
+    }
+  });
+
+  // the same values as one newline-separated buffer
+  std::string log;
+  for (const auto &t : texts) { log += t + '\n'; }
+  std::vector<Accesses> parsed(batch, Accesses{flags::empty});
+
+  s.run(id("parse_log", "parse_records"), batch, no_state,
+        [&](std::uint64_t &acc) {
+    const auto r = flags::parse_records(log.data(), log.data() + log.size(),
+                                        parsed.data(), parsed.size());
+    acc += r.records + static_cast<std::uint64_t>(
+                         parsed.back().underlying_value());
+  });
+
+  s.run(id("parse_log", "from_chars"), batch, no_state,
+        [&](std::uint64_t &acc) {
+    const char *first = log.data();
+    const char *last = log.data() + log.size();
+    for (auto &p : parsed) {
+      const char *end = first;
+      while (*end != '\n') { ++end; }
+      flags::from_chars(first, end, p);
+      first = end + 1;
+    }
+    acc += static_cast<std::uint64_t>(first == last)
+           + static_cast<std::uint64_t>(parsed.back().underlying_value());
+  });
+}
+
+
+void names_conversion(bench::session &s) {
+  run_density(s, density::sparse);
+  run_density(s, density::dense);
+}
+BENCHMARK(names_conversion)
+
+
+} // namespace
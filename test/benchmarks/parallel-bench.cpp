@@ -0,0 +1,84 @@
+#include "bench.hpp"
+
+#include <flags/parallel.hpp>
+
+#include <random>
+#include <string>
+#include <thread>
+
+
+namespace {
+
+
+// Large enough that every thread gets several default-sized chunks.
+constexpr std::size_t batch = std::size_t{1} << 22;
+
+
+template <class E, class Policy>
+void run_policy(bench::session &s, const Policy &policy,
+                const std::string &impl,
+                const std::vector<flags::flags<E>> &values) {
+  using flags_type = flags::flags<E>;
+  auto id = [&](const char *name) {
+    return bench::case_id{name, bench::width<E>(), "random", impl};
+  };
+  const flags_type mask = values[1];
+  const flags::predicate<E> p{values[2] & values[3]};
+  auto copy = [&] { return values; };
+
+  s.run(id("transform_or"), batch, copy,
+        [&](std::vector<flags_type> &state) {
+          flags::transform_or(policy, state.data(),
+                              state.data() + state.size(), mask);
+        });
+  s.run(id("reduce_or"), batch, [] { return flags_type{flags::empty}; },
+        [&](flags_type &result) {
+          result = flags::reduce_or(policy, values.data(),
+                                    values.data() + values.size());
+        });
+  s.run(id("count_if"), batch, [] { return std::size_t{0}; },
+        [&](std::size_t &count) {
+          count = flags::count_if(policy, values.data(),
+                                  values.data() + values.size(), p);
+        });
+
+  std::vector<flags_type> buffer(values.size());
+  s.run(id("partition_by"), batch, copy,
+        [&](std::vector<flags_type> &state) {
+          flags::partition_by(policy, state.data(),
+                              state.data() + state.size(), buffer.data(), p);
+        });
+}
+
+
+// Scaling from one thread to every hardware thread, doubling in between.
+template <class E> void run_width(bench::session &s) {
+  std::mt19937_64 gen(bench::width<E>());
+  std::vector<flags::flags<E>> values;
+  for (std::size_t i = 0; i < batch; ++i) {
+    flags::flags<E> fl{flags::empty};
+    fl.set_underlying_value(
+      static_cast<typename flags::flags<E>::underlying_type>(gen()));
+    values.push_back(fl);
+  }
+
+  run_policy<E>(s, flags::execution::seq, "seq", values);
+  const std::size_t cores = flags::thread_pool::default_concurrency();
+  for (std::size_t threads = 1; ; threads *= 2) {
+    if (threads > cores) { threads = cores; }
+    flags::thread_pool pool(threads);
+    run_policy<E>(s, flags::execution::par.on(pool),
+                  "par_" + std::to_string(threads), values);
+    if (threads == cores) { break; }
+  }
+}
+
+
+void parallel_operations(bench::session &s) {
+  run_width<bench::E8>(s);
+  run_width<bench::E64>(s);
+}
+BENCHMARK(parallel_operations)
+
+
+} // namespace
@@ -0,0 +1,91 @@
+#include "bench.hpp"
+
+#include <flags/parallel.hpp>
+#include <flags/published_flags.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+
+enum class Toggle : unsigned short {};
+
+} // namespace
+
+ALLOW_WIDE_FLAGS_FOR_ENUM(Toggle)
+
+namespace {
+
+
+constexpr std::size_t toggles = 256;
+constexpr std::size_t reads = 1 << 16;
+
+using Toggles = flags::wide_flags<Toggle, toggles>;
+
+
+// Every thread reads the set reads times and tests one toggle. Times are
+// per read of one thread, so that flat rows across thread counts mean
+// reads that do not slow each other down.
+template <class Read>
+void run_reads(bench::session &s, flags::thread_pool &pool,
+               const char *impl, Read read) {
+  const std::size_t threads = pool.concurrency();
+  s.run(bench::case_id{"read_toggles", static_cast<unsigned>(toggles),
+                       std::to_string(threads) + "_threads", impl},
+        reads, [] { return std::size_t{0}; },
+        [&](std::size_t &hits) {
+          std::atomic<std::size_t> total(0);
+          pool.parallel_for(threads, [&](std::size_t t) {
+            std::size_t found = 0;
+            for (std::size_t i = 0; i < reads; ++i) {
+              const Toggles fl = read(t);
+              found += fl.count(static_cast<Toggle>((t + i) % toggles));
+            }
+            total += found;
+          });
+          hits = total;
+        });
+}
+
+
+void published_operations(bench::session &s) {
+  Toggles initial{flags::empty};
+  for (std::size_t i = 0; i < toggles; i += 3) {
+    initial.insert(static_cast<Toggle>(i));
+  }
+
+  const std::size_t cores = flags::thread_pool::default_concurrency();
+  for (std::size_t threads = 1; ; threads *= 2) {
+    if (threads > cores) { threads = cores; }
+    flags::thread_pool pool(threads);
+
+    // what a read costs with nothing shared: a copy per thread
+    std::vector<Toggles> copies(threads * 8, initial);
+    run_reads(s, pool, "private copy", [&](std::size_t t) {
+      return copies[t * 8];
+    });
+
+    std::shared_timed_mutex mutex;
+    Toggles guarded = initial;
+    run_reads(s, pool, "std::shared_timed_mutex", [&](std::size_t) {
+      std::shared_lock<std::shared_timed_mutex> lock(mutex);
+      return guarded;
+    });
+
+    flags::published_flags<Toggle, toggles> published{initial};
+    run_reads(s, pool, "published_flags", [&](std::size_t) {
+      return published.load();
+    });
+
+    if (threads == cores) { break; }
+  }
+}
+BENCHMARK(published_operations)
+
+
+} // namespace
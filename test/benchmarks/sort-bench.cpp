@@ -0,0 +1,80 @@
+#include "bench.hpp"
+
+#include <flags/sort.hpp>
+
+#include <algorithm>
+#include <random>
+
+
+namespace {
+
+
+constexpr std::size_t batch = 1 << 16;
+
+
+template <class E> std::vector<flags::flags<E>> random_values() {
+  using flags_type = flags::flags<E>;
+  std::mt19937_64 gen(bench::width<E>());
+  std::vector<flags_type> values;
+  for (std::size_t i = 0; i < batch; ++i) {
+    flags_type fl{flags::empty};
+    fl.set_underlying_value(
+      static_cast<typename flags_type::underlying_type>(gen()));
+    values.push_back(fl);
+  }
+  return values;
+}
+
+
+template <class E> void run_width(bench::session &s) {
+  using flags_type = flags::flags<E>;
+  const auto values = random_values<E>();
+  std::vector<flags_type> buffer(batch);
+
+  auto id = [](const char *name, const char *impl) {
+    return bench::case_id{name, bench::width<E>(), "random", impl};
+  };
+  auto copy = [&] { return values; };
+
+  s.run(id("sort", "std::sort"), batch, copy,
+        [](std::vector<flags_type> &v) { std::sort(v.begin(), v.end()); });
+  s.run(id("sort", "radix_sort"), batch, copy,
+        [&](std::vector<flags_type> &v) {
+    flags::radix_sort(v.data(), v.data() + v.size(), buffer.data());
+  });
+
+  s.run(id("sort_by_size", "std::sort"), batch, copy,
+        [](std::vector<flags_type> &v) {
+    std::sort(v.begin(), v.end(), flags::size_order{});
+  });
+  s.run(id("sort_by_size", "radix_sort"), batch, copy,
+        [&](std::vector<flags_type> &v) {
+    flags::radix_sort(v.data(), v.data() + v.size(), buffer.data(),
+                      flags::size_order{});
+  });
+
+  std::vector<std::size_t> order(batch), scratch(batch);
+  auto no_state = [] { return std::size_t{0}; };
+  s.run(id("group_by", "std::stable_sort"), batch, no_state,
+        [&](std::size_t &) {
+    for (std::size_t i = 0; i < batch; ++i) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) {
+                       return values[a] < values[b];
+                     });
+  });
+  s.run(id("group_by", "group_by"), batch, no_state, [&](std::size_t &acc) {
+    acc += flags::group_by(values.data(), batch, order.data(),
+                           scratch.data());
+  });
+}
+
+
+void sort_operations(bench::session &s) {
+  run_width<bench::E16>(s);
+  run_width<bench::E64>(s);
+}
+BENCHMARK(sort_operations)
+
+
+} // namespace
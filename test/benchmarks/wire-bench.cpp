@@ -0,0 +1,117 @@
+#include "bench.hpp"
+
+#include <flags/wire.hpp>
+
+#include <cstring>
+#include <random>
+
+
+namespace bench {
+
+enum class Status : std::uint32_t {
+  Online = 1, Degraded = 2, Draining = 4, Maintenance = 8, Alerting = 16
+};
+
+} // namespace bench
+
+ALLOW_FLAGS_FOR_ENUM_VALUES(bench::Status, Online, Degraded, Draining,
+                            Maintenance, Alerting)
+
+
+namespace {
+
+
+using bench::Status;
+using Statuses = flags::flags<Status>;
+using flags::wire_option;
+
+
+constexpr std::size_t batch = 4096;
+
+
+// A state-change stream: runs of a few to a few dozen equal states, each
+// change flipping one flag.
+std::vector<Statuses> make_stream() {
+  std::mt19937 gen(5);
+  std::vector<Statuses> result;
+  std::uint32_t state = 1;
+  while (result.size() < batch) {
+    state ^= 1u << gen() % 5;
+    for (auto run = 1 + gen() % 32; run-- > 0 && result.size() < batch;) {
+      Statuses fl{flags::empty};
+      fl.set_underlying_value(state);
+      result.push_back(fl);
+    }
+  }
+  return result;
+}
+
+
+void run_options(bench::session &s, const std::vector<Statuses> &values,
+                 const char *impl, flags::wire_options options) {
+  std::vector<unsigned char> wire(flags::max_wire_size<Status>(batch));
+  const auto encoded = flags::encode_wire(values.data(), values.size(),
+                                          wire.data(),
+                                          wire.data() + wire.size(), options);
+  std::vector<Statuses> out(batch);
+
+  auto id = [&](const char *name) {
+    return bench::case_id{name, bench::width<Status>(), "state_changes",
+                          impl};
+  };
+  auto no_state = [] { return std::uint64_t{0}; };
+
+  s.run(id("wire_encode"), batch, no_state, [&](std::uint64_t &acc) {
+    const auto r = flags::encode_wire(values.data(), values.size(),
+                                      wire.data(), wire.data() + wire.size(),
+                                      options);
+    acc += static_cast<std::uint64_t>(r.ptr - wire.data());
+  });
+
+  s.run(id("wire_decode"), batch, no_state, [&](std::uint64_t &acc) {
+    const auto r = flags::decode_wire(wire.data(), encoded.ptr, out.data(),
+                                      out.size());
+    acc += r.count + out.back().underlying_value();
+  });
+}
+
+
+void wire_format(bench::session &s) {
+  const auto values = make_stream();
+
+  // the baseline: full-width underlying values, copied byte for byte
+  std::vector<unsigned char> raw(batch * sizeof(std::uint32_t));
+  std::vector<Statuses> out(batch);
+  auto id = [](const char *name) {
+    return bench::case_id{name, bench::width<Status>(), "state_changes",
+                          "raw"};
+  };
+  auto no_state = [] { return std::uint64_t{0}; };
+
+  s.run(id("wire_encode"), batch, no_state, [&](std::uint64_t &acc) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      const std::uint32_t v = values[i].underlying_value();
+      std::memcpy(raw.data() + 4 * i, &v, 4);
+    }
+    acc += raw.back();
+  });
+
+  s.run(id("wire_decode"), batch, no_state, [&](std::uint64_t &acc) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      std::uint32_t v;
+      std::memcpy(&v, raw.data() + 4 * i, 4);
+      out[i].set_underlying_value(v);
+    }
+    acc += out.back().underlying_value();
+  });
+
+  run_options(s, values, "packed", flags::wire_options{flags::empty});
+  run_options(s, values, "delta", wire_option::delta);
+  run_options(s, values, "run_length", wire_option::run_length);
+  run_options(s, values, "delta_run_length",
+              wire_option::delta | wire_option::run_length);
+}
+BENCHMARK(wire_format)
+
+
+} // namespace
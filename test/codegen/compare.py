@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Checks that flags kernels compile to the same code as raw integer ones.
+
+Usage: compare.py OBJECT
+
+Disassembles OBJECT with objdump, pairs every function flags_<kernel> with
+raw_<kernel> and fails if their instruction sequences differ. Addresses and
+trailing alignment padding are ignored.
+"""
+
+import re
+import subprocess
+import sys
+
+
+FUNCTION = re.compile(r"^[0-9a-f]+ <(?P<signature>.+)>:$")
+INSTRUCTION = re.compile(r"^\s*[0-9a-f]+:\s+(?P<text>.+)$")
+PADDING = re.compile(r"^(data16 |cs )*(nop|xchg\s+%ax,%ax|int3)")
+
+
+def normalize(text):
+    text = text.split("#")[0]
+    # jump and call targets are absolute offsets into the object file
+    text = re.sub(r"\s*<.*>$", "", text)
+    text = re.sub(r"\b[0-9a-f]+\s*$", "ADDR", text)
+    return " ".join(text.split())
+
+
+def functions(obj):
+    listing = subprocess.check_output(
+        ["objdump", "-d", "-C", "--no-show-raw-insn", obj],
+        universal_newlines=True,
+    )
+    result = {}
+    current = None
+    for line in listing.splitlines():
+        header = FUNCTION.match(line)
+        if header:
+            name = header.group("signature").split("(")[0]
+            current = result.setdefault(name, [])
+            continue
+        instruction = INSTRUCTION.match(line)
+        if current is not None and instruction:
+            current.append(normalize(instruction.group("text")))
+    for body in result.values():
+        while body and PADDING.match(body[-1]):
+            body.pop()
+    return result
+
+
+def main(obj):
+    code = functions(obj)
+    kernels = sorted(n[len("flags_"):] for n in code if n.startswith("flags_"))
+    if not kernels:
+        print("no kernels found in " + obj)
+        return 1
+
+    failures = 0
+    for kernel in kernels:
+        wrapped = code["flags_" + kernel]
+        raw = code.get("raw_" + kernel)
+        if raw is None:
+            print("%s: missing raw_%s" % (kernel, kernel))
+            failures += 1
+        elif wrapped != raw:
+            print("%s: code differs" % kernel)
+            print("  flags: " + "; ".join(wrapped))
+            print("  raw:   " + "; ".join(raw))
+            failures += 1
+        else:
+            print("%s: %d instructions" % (kernel, len(raw)))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1]))
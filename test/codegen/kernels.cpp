@@ -0,0 +1,75 @@
+// Every kernel here comes in two versions: flags_<name>_<width> written
+// against flags::flags, and raw_<name>_<width> written against the bare
+// integer. compare.py checks that both versions of each kernel compile to
+// the same instructions.
+
+#include <flags/flags.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+
+enum class U32 : std::uint32_t { One = 1 };
+ALLOW_FLAGS_FOR_ENUM(U32)
+
+enum class U64 : std::uint64_t { One = 1 };
+ALLOW_FLAGS_FOR_ENUM(U64)
+
+
+#define KERNELS(width, E, raw) \
+void flags_or_assign_##width(flags::flags<E> &a, flags::flags<E> b) { \
+  a |= b; \
+} \
+void raw_or_assign_##width(raw &a, raw b) { a |= b; } \
+\
+flags::flags<E> flags_and_##width(flags::flags<E> a, flags::flags<E> b) { \
+  return a & b; \
+} \
+raw raw_and_##width(raw a, raw b) { return a & b; } \
+\
+flags::flags<E> flags_not_##width(flags::flags<E> a) { return ~a; } \
+raw raw_not_##width(raw a) { return ~a; } \
+\
+bool flags_to_bool_##width(flags::flags<E> a) { \
+  return static_cast<bool>(a); \
+} \
+bool raw_to_bool_##width(raw a) { return a != 0; } \
+\
+raw flags_underlying_value_##width(flags::flags<E> a) { \
+  return a.underlying_value(); \
+} \
+raw raw_underlying_value_##width(raw a) { return a; } \
+\
+bool flags_find_##width(flags::flags<E> a, E e) { \
+  return a.find(e) != a.end(); \
+} \
+bool raw_find_##width(raw a, raw e) { return (a & e) != 0; } \
+\
+std::size_t flags_count_##width(flags::flags<E> a, E e) { \
+  return a.count(e); \
+} \
+std::size_t raw_count_##width(raw a, raw e) { return (a & e) != 0; } \
+\
+bool flags_any_of_##width(flags::flags<E> a, flags::flags<E> m) { \
+  return a.any_of(m); \
+} \
+bool raw_any_of_##width(raw a, raw m) { return (a & m) != 0; } \
+\
+bool flags_all_of_##width(flags::flags<E> a, flags::flags<E> m) { \
+  return a.all_of(m); \
+} \
+bool raw_all_of_##width(raw a, raw m) { return (a & m) == m; } \
+\
+bool flags_is_subset_of_##width(flags::flags<E> a, flags::flags<E> b) { \
+  return a.is_subset_of(b); \
+} \
+bool raw_is_subset_of_##width(raw a, raw b) { return (a & ~b) == 0; } \
+\
+bool flags_intersects_##width(flags::flags<E> a, flags::flags<E> b) { \
+  return a.intersects(b); \
+} \
+bool raw_intersects_##width(raw a, raw b) { return (a & b) != 0; }
+
+
+KERNELS(u32, U32, std::uint32_t)
+KERNELS(u64, U64, std::uint64_t)
@@ -4,6 +4,11 @@
 
 #include <flags/flags.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
 
 enum class Enum : int {One = 1, Two = 2, Four = 4, Eight = 8};
 ALLOW_FLAGS_FOR_ENUM(Enum)
@@ -17,4 +22,38 @@ ALLOW_FLAGS_FOR_ENUM(SmallEnum)
 using SmallEnums = flags::flags<SmallEnum>;
 
 
+// No enumerators: values of all 64 bits come from from_raw.
+enum class Wide : std::uint64_t {};
+ALLOW_FLAGS_FOR_ENUM(Wide)
+
+using Wides = flags::flags<Wide>;
+
+
+// The flags of E with the low bits of raw.
+template <class E>
+flags::flags<E> from_raw(std::uint64_t raw) {
+  flags::flags<E> fl{flags::empty};
+  fl.set_underlying_value(
+    static_cast<typename flags::flags<E>::underlying_type>(raw));
+  return fl;
+}
+
+// n values of E over its low bits bits, the same for the same arguments.
+// Bit b is set with probability about (b % 8 + 1) / 9, so that neighbouring
+// bits are set in different numbers of values.
+template <class E>
+std::vector<flags::flags<E>> make_values(std::size_t n, unsigned bits = 64) {
+  std::mt19937_64 gen(n + bits);
+  std::vector<flags::flags<E>> values;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::uint64_t raw = 0;
+    for (unsigned b = 0; b < bits && b < flags::flags<E>::bit_size(); ++b) {
+      raw |= static_cast<std::uint64_t>(gen() % 9 <= b % 8) << b;
+    }
+    values.push_back(from_raw<E>(raw));
+  }
+  return values;
+}
+
+
 #endif // ENUM_CLASS_TEST_COMMON_HPP
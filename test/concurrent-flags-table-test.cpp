@@ -0,0 +1,119 @@
+#include "common.hpp"
+
+#include <flags/concurrent_flags_table.hpp>
+
+#include <cstdint>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Session : std::uint32_t {};
+
+
+void test_operations() {
+  flags::concurrent_flags_table<std::uint64_t, Enum> table(100, 3);
+  BOOST_TEST_EQ(128u, table.capacity());
+  BOOST_TEST_EQ(4u, table.shard_count());
+  BOOST_TEST(table.empty());
+
+  BOOST_TEST(!table.contains(7));
+  BOOST_TEST(!table.test(7, Enums{flags::empty}));
+  BOOST_TEST(table.load(7).empty());
+  BOOST_TEST(!table.erase_flags(7, Enum::One));
+
+  BOOST_TEST(table.insert_flags(7, Enum::One | Enum::Two));
+  BOOST_TEST(table.insert_flags(7, Enums{Enum::Eight}));
+  BOOST_TEST(table.insert_flags(0, Enums{flags::empty}));
+  BOOST_TEST_EQ(2u, table.size());
+  BOOST_TEST(table.test(7, Enum::One | Enum::Eight));
+  BOOST_TEST(!table.test(7, Enum::One | Enum::Four));
+  BOOST_TEST(table.contains(0));
+  BOOST_TEST(table.load(0).empty());
+
+  BOOST_TEST(table.erase_flags(7, Enum::One | Enum::Eight));
+  BOOST_TEST(table.load(7) == Enum::Two);
+  BOOST_TEST(table.erase_flags(7, Enums{Enum::Two}));
+  BOOST_TEST(table.contains(7));
+  BOOST_TEST_EQ(2u, table.size());
+
+  // the one key that cannot be stored
+  BOOST_TEST(!table.insert_flags(~std::uint64_t{0}, Enums{Enum::One}));
+  BOOST_TEST(!table.contains(~std::uint64_t{0}));
+
+  std::map<std::uint64_t, Enums> seen;
+  table.for_each([&](std::uint64_t key, Enums fl) { seen[key] = fl; });
+  BOOST_TEST_EQ(2u, seen.size());
+  BOOST_TEST(seen[7].empty());
+
+  table.clear();
+  BOOST_TEST(table.empty());
+  BOOST_TEST(!table.contains(7));
+}
+
+
+void test_full_shards() {
+  // one shard of four slots
+  flags::concurrent_flags_table<Session, SmallEnum> table(4, 1);
+  for (std::uint32_t i = 0; i < 4; ++i) {
+    BOOST_TEST(table.insert_flags(static_cast<Session>(i),
+                                  SmallEnums{SmallEnum::SmallOne}));
+  }
+  BOOST_TEST(!table.insert_flags(static_cast<Session>(4),
+                                 SmallEnums{SmallEnum::SmallOne}));
+  BOOST_TEST(table.insert_flags(static_cast<Session>(2),
+                                SmallEnums{SmallEnum::SmallTwo}));
+  BOOST_TEST(!table.contains(static_cast<Session>(4)));
+  BOOST_TEST(table.load(static_cast<Session>(2))
+             == (SmallEnum::SmallOne | SmallEnum::SmallTwo));
+
+  std::size_t keys = 0;
+  table.for_each([&](Session, SmallEnums) { ++keys; });
+  BOOST_TEST_EQ(4u, keys);
+}
+
+
+// Threads insert the same keys with their own flag, then erase half of
+// them, while others read.
+void test_concurrent_updates() {
+  constexpr unsigned threads = 4;
+  constexpr std::int64_t keys = 5000;
+  flags::concurrent_flags_table<std::int64_t, Enum> table(4 * keys, 8);
+  const Enum own[threads] = {Enum::One, Enum::Two, Enum::Four, Enum::Eight};
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (std::int64_t k = -keys / 2; k < keys / 2; ++k) {
+        table.insert_flags(k * 977, Enums{own[t]});
+      }
+      for (std::int64_t k = -keys / 2; k < keys / 2; k += 2) {
+        table.erase_flags(k * 977, Enums{own[t]});
+      }
+    });
+  }
+  std::size_t reads = 0;
+  for (std::int64_t k = -keys / 2; k < keys / 2; ++k) {
+    reads += table.test(k * 977, Enums{Enum::One}) ? 1 : 0;
+  }
+  for (auto &worker : workers) { worker.join(); }
+  BOOST_TEST_LE(reads, static_cast<std::size_t>(keys));
+
+  BOOST_TEST_EQ(static_cast<std::size_t>(keys), table.size());
+  for (std::int64_t k = -keys / 2; k < keys / 2; ++k) {
+    const Enums expected = k % 2 == 0
+      ? Enums{flags::empty}
+      : Enum::One | Enum::Two | Enum::Four | Enum::Eight;
+    BOOST_TEST(table.load(k * 977) == expected);
+  }
+}
+
+
+int main() {
+  test_operations();
+  test_full_shards();
+  test_concurrent_updates();
+  return boost::report_errors();
+}
@@ -0,0 +1,175 @@
+#include "common.hpp"
+
+#include <flags/event_group.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+namespace flags {
+template <class E>
+auto operator<<(std::ostream& o, flags<E> fl) -> std::ostream& {
+  return o << "flags<" << fl.underlying_value() << '>';
+}
+} // namespace flags
+
+
+using Group = flags::event_group<Enum>;
+
+
+void test_immediate() {
+  Group group{Enum::One | Enum::Two};
+  BOOST_TEST_EQ(group.wait_all(Enum::One | Enum::Two), Enum::One | Enum::Two);
+  BOOST_TEST_EQ(group.wait_any(Enum::Two | Enum::Four, true),
+                Enum::One | Enum::Two);
+  BOOST_TEST_EQ(group.get(), Enums{Enum::One});
+
+  BOOST_TEST_EQ(group.clear(Enum::One), Enums{Enum::One});
+  BOOST_TEST(group.get().empty());
+  BOOST_TEST_EQ(group.set(Enum::Eight), Enums{Enum::Eight});
+}
+
+
+void test_empty_mask() {
+  // nothing to wait for, with any mode: these must not block
+  Group group{Enum::Two};
+  const Enums none{flags::empty};
+  BOOST_TEST_EQ(group.wait_all(none), Enums{Enum::Two});
+  BOOST_TEST_EQ(group.wait_any(none), Enums{Enum::Two});
+  BOOST_TEST_EQ(group.wait_any(none, true), Enums{Enum::Two});
+  BOOST_TEST_EQ(group.wait_any_for(none, std::chrono::hours(1)),
+                Enums{Enum::Two});
+
+  group.clear(Enum::Two);
+  BOOST_TEST(group.wait_any(none).empty());
+}
+
+
+void test_timeout() {
+  Group group{Enum::One};
+  const auto value = group.wait_all_for(Enum::One | Enum::Two,
+                                        std::chrono::milliseconds(10));
+  BOOST_TEST_NOT(value.all_of(Enum::One | Enum::Two));
+  BOOST_TEST_EQ(value, Enums{Enum::One});
+
+  // the timed-out waiter must be gone; setting the bits now finds nobody
+  BOOST_TEST_EQ(group.set(Enum::Two), Enum::One | Enum::Two);
+  BOOST_TEST(group.wait_any_for(Enum::Two, std::chrono::milliseconds(10))
+             .all_of(Enum::Two));
+}
+
+
+void test_blocking() {
+  Group group;
+  std::atomic<int> woken{0};
+
+  std::thread all([&] {
+    BOOST_TEST(group.wait_all(Enum::One | Enum::Two).all_of(Enum::One
+                                                            | Enum::Two));
+    ++woken;
+  });
+  std::thread any([&] {
+    BOOST_TEST(group.wait_any(Enum::Four | Enum::Eight, true)
+               .any_of(Enum::Four | Enum::Eight));
+    ++woken;
+  });
+
+  // waits for both threads to be queued or done before setting anything
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  group.set(Enum::One);
+  group.set(Enum::Eight);
+  any.join();
+  BOOST_TEST_EQ(1, woken.load());
+  BOOST_TEST_EQ(group.get(), Enums{Enum::One});
+
+  group.set(Enum::Two);
+  all.join();
+  BOOST_TEST_EQ(2, woken.load());
+}
+
+
+void test_auto_clear_fifo() {
+  Group group;
+  std::vector<std::thread> threads;
+  std::atomic<int> woken{0};
+  for (int t = 0; t != 3; ++t) {
+    threads.emplace_back([&] {
+      group.wait_all(Enum::Four, true);
+      ++woken;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // each set satisfies exactly one waiter, which clears the bit again
+  for (int expected = 1; expected <= 3; ++expected) {
+    BOOST_TEST(group.set(Enum::Four).empty());
+    while (woken.load() < expected) std::this_thread::yield();
+    BOOST_TEST_EQ(expected, woken.load());
+  }
+  for (auto &thread : threads) thread.join();
+}
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_COROUTINES
+struct task {
+  struct promise_type {
+    task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {}
+  };
+};
+
+task waiter_coroutine(Group &group, Enums mask, Enums &seen) {
+  seen = co_await group.async_wait_all(mask, true);
+}
+
+task any_waiter_coroutine(Group &group, Enums mask, Enums &seen) {
+  seen = co_await group.async_wait_any(mask);
+}
+
+void test_coroutine() {
+  Group group;
+  Enums first{flags::empty};
+  Enums second{flags::empty};
+  waiter_coroutine(group, Enum::One | Enum::Two, first);
+  waiter_coroutine(group, Enums{Enum::Four}, second);
+  BOOST_TEST(first.empty());
+
+  group.set(Enum::One);
+  BOOST_TEST(first.empty());
+  BOOST_TEST(group.set(Enum::Two | Enum::Four).empty());
+  BOOST_TEST_EQ(first, Enum::One | Enum::Two | Enum::Four);
+  BOOST_TEST_EQ(second, Enums{Enum::Four});
+
+  // already satisfied: completes without suspending
+  Enums third{flags::empty};
+  group.set(Enum::Eight);
+  waiter_coroutine(group, Enums{Enum::Eight}, third);
+  BOOST_TEST_EQ(third, Enums{Enum::Eight});
+
+  // nothing to wait for
+  Enums fourth{flags::empty};
+  group.set(Enum::Four);
+  any_waiter_coroutine(group, Enums{flags::empty}, fourth);
+  BOOST_TEST_EQ(fourth, Enums{Enum::Four});
+}
+#endif
+
+
+int main() {
+  test_immediate();
+  test_empty_mask();
+  test_timeout();
+  test_blocking();
+  test_auto_clear_fifo();
+#ifdef ENUM_CLASS_FLAGS_HAS_COROUTINES
+  test_coroutine();
+#endif
+  return boost::report_errors();
+}
@@ -0,0 +1,84 @@
+#include "common.hpp"
+
+#include <flags/flags_accumulator.hpp>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+Wides nth(unsigned n) { return Wides{static_cast<Wide>(1ull << n)}; }
+
+
+void test_single_thread() {
+  flags::flags_accumulator<Enum> acc(3);
+  BOOST_TEST_EQ(4u, acc.slot_count());
+  BOOST_TEST(acc.united().empty());
+  BOOST_TEST(acc.intersected() == Enums::all());
+
+  acc |= Enum::One;
+  acc |= Enum::One | Enum::Four;
+  acc &= Enum::One | Enum::Two;
+  acc &= Enum::Two | Enum::Eight;
+  BOOST_TEST(acc.united() == (Enum::One | Enum::Four));
+  BOOST_TEST(acc.intersected() == Enum::Two);
+
+  const auto first = acc.snapshot_and_reset();
+  BOOST_TEST(first.united == (Enum::One | Enum::Four));
+  BOOST_TEST(first.intersected == Enum::Two);
+  BOOST_TEST_EQ(1u, first.epoch);
+  BOOST_TEST_EQ(1u, acc.epoch());
+
+  BOOST_TEST(acc.united().empty());
+  BOOST_TEST(acc.intersected() == Enums::all());
+  acc |= Enum::Eight;
+  const auto second = acc.snapshot_and_reset();
+  BOOST_TEST(second.united == Enum::Eight);
+  BOOST_TEST(second.intersected == Enums::all());
+  BOOST_TEST_EQ(2u, second.epoch);
+}
+
+
+// Threads report their own flags while another one keeps flushing: every
+// report is in exactly one snapshot.
+void test_concurrent_reports() {
+  constexpr unsigned threads = 8;
+  constexpr unsigned rounds = 20000;
+  flags::flags_accumulator<Wide> acc(threads / 2);
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&acc, t] {
+      for (unsigned i = 0; i < rounds; ++i) {
+        acc |= nth(t * 8 + i % 8);
+        acc &= ~nth(t);
+      }
+    });
+  }
+
+  Wides united{flags::empty};
+  Wides intersected = Wides::all();
+  std::uint64_t epoch = 0;
+  for (int i = 0; i < 100; ++i) {
+    const auto s = acc.snapshot_and_reset();
+    BOOST_TEST_EQ(++epoch, s.epoch);
+    united |= s.united;
+    intersected &= s.intersected;
+    std::this_thread::yield();
+  }
+  for (auto &worker : workers) { worker.join(); }
+  united |= acc.united();
+  intersected &= acc.intersected();
+
+  BOOST_TEST(united == Wides{static_cast<Wide>(~0ull)});
+  BOOST_TEST(intersected == ~Wides{static_cast<Wide>(0xffull)});
+}
+
+
+int main() {
+  test_single_thread();
+  test_concurrent_reports();
+  return boost::report_errors();
+}
@@ -0,0 +1,238 @@
+#include "common.hpp"
+
+#include <flags/flags_map.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+void test_hash() {
+  std::hash<Enums> h;
+  BOOST_TEST_EQ(h(Enum::One), h(Enums{Enum::One}));
+  BOOST_TEST_NE(h(Enum::One), h(Enum::Two));
+
+  // small values spread over the whole range
+  std::unordered_set<std::size_t> top_bytes;
+  for (std::uint64_t i = 0; i < 256; ++i) {
+    top_bytes.insert(std::hash<Wides>{}(from_raw<Wide>(i))
+                     >> (sizeof(std::size_t) * 8 - 8));
+  }
+  BOOST_TEST_GT(top_bytes.size(), 140u);
+
+  std::unordered_map<Enums, int> m;
+  m[Enum::One | Enum::Two] = 3;
+  BOOST_TEST_EQ(3, m[Enum::Two | Enum::One]);
+}
+
+
+void test_map() {
+  flags::flags_map<Enum, std::string> m;
+  BOOST_TEST(m.empty());
+  BOOST_TEST(m.begin() == m.end());
+  BOOST_TEST(m.find(Enum::One) == m.end());
+  BOOST_TEST_EQ(0u, m.erase(Enum::One));
+
+  BOOST_TEST(m.insert({Enum::One, "one"}).second);
+  BOOST_TEST(!m.insert({Enum::One, "uno"}).second);
+  BOOST_TEST(m.try_emplace(Enum::Two | Enum::Four, 3, 'x').second);
+  m[Enums{flags::empty}] = "none";
+
+  BOOST_TEST_EQ(3u, m.size());
+  BOOST_TEST_EQ("one", m[Enum::One]);
+  BOOST_TEST_EQ("xxx", m.find(Enum::Four | Enum::Two)->second);
+  BOOST_TEST(m.contains(Enums{flags::empty}));
+  BOOST_TEST_EQ(0u, m.count(Enum::Eight));
+
+  BOOST_TEST(!m.insert_or_assign(Enum::One, "uno").second);
+  BOOST_TEST_EQ("uno", m[Enum::One]);
+
+  std::size_t visited = 0;
+  for (const auto &kv : m) {
+    BOOST_TEST(m.find(kv.first)->second == kv.second);
+    ++visited;
+  }
+  BOOST_TEST_EQ(3u, visited);
+
+  const auto copy = m;
+  BOOST_TEST(copy == m);
+  BOOST_TEST_EQ(1u, m.erase(Enum::One));
+  BOOST_TEST(copy != m);
+  BOOST_TEST_EQ(2u, m.size());
+  BOOST_TEST(!m.contains(Enum::One));
+  BOOST_TEST(copy.contains(Enum::One));
+
+  auto moved = std::move(m);
+  BOOST_TEST_EQ(2u, moved.size());
+  moved.clear();
+  BOOST_TEST(moved.empty());
+  BOOST_TEST(moved.begin() == moved.end());
+}
+
+
+void test_growth_and_erase() {
+  // against std::unordered_map, through growth and many tombstones
+  flags::flags_map<Wide, std::unique_ptr<std::uint64_t>> m;
+  std::unordered_map<std::uint64_t, std::uint64_t> expected;
+
+  std::uint64_t x = 1;
+  for (int round = 0; round < 20000; ++round) {
+    x = x * 6364136223846793005u + 1442695040888963407u;
+    const std::uint64_t key = (x >> 40) % 3000;
+    if ((x >> 20) % 3) {
+      m.try_emplace(from_raw<Wide>(key))
+        .first->second.reset(new std::uint64_t(x));
+      expected[key] = x;
+    } else {
+      BOOST_TEST_EQ(expected.erase(key), m.erase(from_raw<Wide>(key)));
+    }
+  }
+
+  BOOST_TEST_EQ(expected.size(), m.size());
+  for (const auto &kv : expected) {
+    const auto i = m.find(from_raw<Wide>(kv.first));
+    BOOST_TEST(i != m.end() && *i->second == kv.second);
+  }
+
+  // erasing while iterating
+  for (auto i = m.begin(); i != m.end();) {
+    i = i->first.underlying_value() % 2 ? m.erase(i) : std::next(i);
+  }
+  for (const auto &kv : m) {
+    BOOST_TEST(kv.first.underlying_value() % 2 == 0);
+  }
+
+  flags::flags_map<Wide, int> reserved(1000);
+  const auto capacity = reserved.capacity();
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    reserved[from_raw<Wide>(i << 32)] = 1;
+  }
+  BOOST_TEST_EQ(capacity, reserved.capacity());
+  BOOST_TEST_EQ(1000u, reserved.size());
+}
+
+
+void test_set() {
+  flags::flags_set<Enum> s{Enum::One, Enum::One | Enum::Two,
+                           Enums{flags::empty}};
+  BOOST_TEST_EQ(3u, s.size());
+  BOOST_TEST(!s.insert(Enum::One).second);
+  BOOST_TEST(s.insert(Enum::Eight).second);
+  BOOST_TEST(s.contains(Enum::Two | Enum::One));
+  BOOST_TEST(*s.find(Enum::Eight) == Enum::Eight);
+
+  Enums all{flags::empty};
+  for (auto fl : s) { all |= fl; }
+  BOOST_TEST(all == (Enum::One | Enum::Two | Enum::Eight));
+
+  flags::flags_set<Enum> other;
+  for (auto fl : s) { other.insert(fl); }
+  BOOST_TEST(other == s);
+  BOOST_TEST_EQ(1u, other.erase(Enum::One));
+  BOOST_TEST(other != s);
+
+  flags::flags_set<Wide> many;
+  for (std::uint64_t i = 0; i < 5000; ++i) {
+    many.insert(from_raw<Wide>(i * i));
+  }
+  BOOST_TEST_EQ(5000u, many.size());
+  for (std::uint64_t i = 0; i < 5000; i += 2) {
+    many.erase(from_raw<Wide>(i * i));
+  }
+  BOOST_TEST_EQ(2500u, many.size());
+  BOOST_TEST(many.contains(from_raw<Wide>(9)));
+  BOOST_TEST(!many.contains(from_raw<Wide>(16)));
+}
+
+
+void test_copy_with_tombstones() {
+  // 17 keys of the first of two groups: the last one overflows into the
+  // second group, and erasing one of the others leaves a tombstone
+  std::vector<Wides> keys;
+  for (std::uint64_t raw = 0; keys.size() < 17; ++raw) {
+    if (!((flags::detail::mix64(raw) >> 7) & 1)) {
+      keys.push_back(from_raw<Wide>(raw));
+    }
+  }
+
+  flags::flags_set<Wide> s(keys.size());
+  BOOST_TEST_EQ(32u, s.capacity());
+  for (auto fl : keys) { s.insert(fl); }
+  s.erase(keys[3]);
+
+  const flags::flags_set<Wide> copy = s;
+  BOOST_TEST(copy.contains(keys[16]));
+  BOOST_TEST(!copy.contains(keys[3]));
+  BOOST_TEST(copy == s);
+
+  flags::flags_set<Wide> assigned;
+  assigned = s;
+  BOOST_TEST(assigned.contains(keys[16]));
+  BOOST_TEST(!assigned.insert(keys[16]).second);
+  BOOST_TEST_EQ(16u, assigned.size());
+}
+
+
+// Counts live instances; the copy that would make copies_left negative
+// throws instead. Moves never throw.
+struct fragile {
+  static int live;
+  static int copies_left;
+
+  fragile() { ++live; }
+  fragile(const fragile &) {
+    if (--copies_left < 0) { throw std::runtime_error("copy"); }
+    ++live;
+  }
+  fragile(fragile &&) noexcept { ++live; }
+  ~fragile() { --live; }
+};
+
+int fragile::live = 0;
+int fragile::copies_left = 0;
+
+
+void test_throwing_copy() {
+  {
+    flags::flags_map<Wide, fragile> m;
+    for (std::uint64_t i = 0; i < 100; ++i) { m[from_raw<Wide>(i)]; }
+    BOOST_TEST_EQ(100, fragile::live);
+
+    fragile::copies_left = 40;
+    bool thrown = false;
+    try {
+      const auto copy = m;
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    BOOST_TEST(thrown);
+    BOOST_TEST_EQ(100, fragile::live);
+
+    flags::flags_map<Wide, fragile> assigned;
+    assigned[from_raw<Wide>(7)];
+    fragile::copies_left = 40;
+    try {
+      assigned = m;
+    } catch (const std::runtime_error &) {}
+    BOOST_TEST_EQ(1u, assigned.size());
+    BOOST_TEST_EQ(101, fragile::live);
+  }
+  BOOST_TEST_EQ(0, fragile::live);
+}
+
+
+int main() {
+  test_hash();
+  test_map();
+  test_growth_and_erase();
+  test_set();
+  test_copy_with_tombstones();
+  test_throwing_copy();
+  return boost::report_errors();
+}
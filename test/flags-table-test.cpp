@@ -0,0 +1,132 @@
+#include "common.hpp"
+
+#include <flags/flags_table.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Sparse : std::uint32_t {A = 1, B = 1 << 4, C = 1 << 9,
+                                   D = 1u << 30};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Sparse, A, B, C, D)
+
+enum class Shifted : std::uint8_t {X = 4, Y = 8, Z = 16};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Shifted, X, Y, Z)
+
+using Sparses = flags::flags<Sparse>;
+using Shifteds = flags::flags<Shifted>;
+
+
+constexpr int weight(Sparses fl) {
+  return (fl & Sparse::A ? 1 : 0) + (fl & Sparse::B ? 10 : 0)
+         + (fl & Sparse::C ? 100 : 0) + (fl & Sparse::D ? 1000 : 0);
+}
+
+constexpr unsigned raw_size(Shifteds fl) {
+  return static_cast<unsigned>(fl.underlying_value());
+}
+
+
+void test_bits() {
+  using flags::detail::extract_bits;
+  using flags::detail::deposit_bits;
+  using flags::detail::extract_bits_fast;
+
+  static_assert(extract_bits(0xf0u, 0x30u) == 3u, "");
+  static_assert(extract_bits(0x50u, 0xf0u) == 5u, "");
+  static_assert(deposit_bits(3u, 0x30u) == 0x30u, "");
+  static_assert(deposit_bits(5u, 0x0f0u) == 0x50u, "");
+
+  std::uint64_t x = 1;
+  for (int i = 0; i < 1000; ++i) {
+    x = x * 6364136223846793005u + 1442695040888963407u;
+    const std::uint64_t mask = x ^ (x >> 17) << 3;
+    const std::uint64_t value = x * 0x9e3779b97f4a7c15u;
+    const std::uint64_t packed = extract_bits(value, mask);
+    BOOST_TEST_EQ(packed, extract_bits_fast(value, mask));
+    BOOST_TEST_EQ(value & mask, deposit_bits(packed, mask));
+    const auto narrow = static_cast<std::uint32_t>(value);
+    const auto narrow_mask = static_cast<std::uint32_t>(mask);
+    BOOST_TEST_EQ(extract_bits(narrow, narrow_mask),
+                  extract_bits_fast(narrow, narrow_mask));
+  }
+}
+
+
+void test_sparse() {
+  using Table = flags::flags_table<Sparse, std::string>;
+  static_assert(Table::size() == 16, "");
+
+  Table table;
+  for (std::size_t i = 0; i < Table::size(); ++i) {
+    BOOST_TEST_EQ(i, Table::index(Table::key(i)));
+    BOOST_TEST(table[Table::key(i)].empty());
+  }
+
+  table[Sparse::A | Sparse::D] = "ad";
+  table[Sparses{flags::empty}] = "none";
+  BOOST_TEST_EQ("ad", table[Sparse::D | Sparse::A]);
+  BOOST_TEST_EQ("none", table[Sparses{flags::empty}]);
+  BOOST_TEST_EQ("none", table.begin()[0]);
+  BOOST_TEST(table.data() + 9 == &table[Sparse::A | Sparse::D]);
+
+  // bits outside the valid ones do not matter
+  Sparses noisy{Sparse::A | Sparse::D};
+  noisy.set_underlying_value(noisy.underlying_value() | 0x6);
+  BOOST_TEST_EQ("ad", table[noisy]);
+
+  const Table filled("x");
+  for (const auto &s : filled) { BOOST_TEST_EQ("x", s); }
+}
+
+
+void test_contiguous() {
+  using Table = flags::flags_table<Shifted, int>;
+  static_assert(Table::size() == 8, "");
+  static_assert(Table::index(Shifted::X | Shifted::Z) == 5, "");
+  static_assert(Table::key(2) == Shifted::Y, "");
+
+  Table table(-1);
+  table[Shifted::Y] = 2;
+  BOOST_TEST_EQ(2, table[Shifted::Y]);
+  BOOST_TEST_EQ(-1, table[Shifted::X]);
+
+  // every bit of the underlying type valid
+  using Plain = flags::flags_table<SmallEnum, int>;
+  static_assert(Plain::size() == 256, "");
+  Plain counts;
+  for (int i = 0; i < 1000; ++i) {
+    ++counts[SmallEnums{static_cast<SmallEnum>(i & 0xff)}];
+  }
+  BOOST_TEST_EQ(4, counts[SmallEnums{static_cast<SmallEnum>(0)}]);
+  BOOST_TEST_EQ(3, counts[SmallEnums{static_cast<SmallEnum>(255)}]);
+}
+
+
+void test_generate() {
+  constexpr auto weights =
+    flags::flags_table<Sparse, int>::generate(weight);
+  static_assert(weights.lookup(Sparse::B | Sparse::D) == 1010, "");
+  static_assert(weights.lookup(Sparses{flags::empty}) == 0, "");
+
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    const auto key = weights.key(i);
+    BOOST_TEST_EQ(weight(key), weights[key]);
+  }
+
+  constexpr auto sizes =
+    flags::flags_table<Shifted, unsigned>::generate(raw_size);
+  static_assert(sizes.lookup(Shifted::X | Shifted::Y) == 12, "");
+  BOOST_TEST_EQ(28u, sizes[Shifteds::all()]);
+}
+
+
+int main() {
+  test_bits();
+  test_sparse();
+  test_contiguous();
+  test_generate();
+  return boost::report_errors();
+}
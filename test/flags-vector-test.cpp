@@ -0,0 +1,129 @@
+#include "common.hpp"
+
+#include <flags/flags_vector.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class WideEnum : std::uint64_t {Low = 1, High = 1ull << 63};
+ALLOW_FLAGS_FOR_ENUM(WideEnum)
+
+enum class ShortEnum : std::uint16_t {Low = 1, High = 1u << 15};
+ALLOW_FLAGS_FOR_ENUM(ShortEnum)
+
+
+namespace flags {
+template <class E>
+auto operator<<(std::ostream& o, flags<E> fl) -> std::ostream& {
+  return o << "flags<" << fl.underlying_value() << '>';
+}
+} // namespace flags
+
+
+// Long enough to cover both the vector body and the scalar tail of the
+// kernels for every element width.
+constexpr std::size_t column_size = 77;
+
+
+void test_container() {
+  flags::flags_vector<Enum> vec;
+  BOOST_TEST(vec.empty());
+  BOOST_TEST(vec.begin() == vec.end());
+
+  vec.push_back(Enum::One);
+  vec.push_back(Enum::Two | Enum::Four);
+  BOOST_TEST_EQ(2u, vec.size());
+  BOOST_TEST_EQ(vec[0], Enums{Enum::One});
+  BOOST_TEST_EQ(vec.back(), Enum::Two | Enum::Four);
+
+  vec.set(0, Enum::Eight);
+  BOOST_TEST_EQ(vec.front(), Enums{Enum::Eight});
+  BOOST_TEST_EQ(0u, reinterpret_cast<std::uintptr_t>(vec.data()) % 64);
+
+  std::vector<Enums> copy(vec.begin(), vec.end());
+  BOOST_TEST_EQ(2u, copy.size());
+  BOOST_TEST_EQ(copy[1], vec[1]);
+  BOOST_TEST_EQ(2, vec.end() - vec.begin());
+  BOOST_TEST_EQ(vec.begin()[1], vec[1]);
+
+  const flags::flags_vector<Enum> il{Enum::Eight, Enum::Two | Enum::Four};
+  BOOST_TEST(il == vec);
+  vec.pop_back();
+  BOOST_TEST(il != vec);
+
+  vec.resize(4, Enum::One);
+  BOOST_TEST_EQ(vec[3], Enums{Enum::One});
+  vec.clear();
+  BOOST_TEST(vec.empty());
+}
+
+
+template <class E>
+void test_bulk(E low, E high) {
+  using flags_type = flags::flags<E>;
+  flags::flags_vector<E> column;
+  std::vector<flags_type> expected;
+  for (std::size_t i = 0; i != column_size; ++i) {
+    flags_type fl{flags::empty};
+    if (i % 2) fl |= low;
+    if (i % 3 == 0) fl |= high;
+    column.push_back(fl);
+    expected.push_back(fl);
+  }
+
+  BOOST_TEST_EQ(26u, column.count_matching(high));
+  BOOST_TEST_EQ(13u, column.count_matching(low | high));
+  BOOST_TEST_EQ(column_size, column.count_matching(flags_type{flags::empty}));
+  BOOST_TEST(column.any_matching(low | high));
+
+  std::vector<unsigned char> sizes(column_size);
+  column.sizes(sizes.data());
+  for (std::size_t i = 0; i != column_size; ++i) {
+    BOOST_TEST_EQ(expected[i].size(), sizes[i]);
+  }
+
+  auto ored = column;
+  ored |= low;
+  BOOST_TEST_EQ(column_size, ored.count_matching(low));
+
+  auto anded = column;
+  anded &= high;
+  BOOST_TEST_EQ(0u, anded.count_matching(low));
+  BOOST_TEST_EQ(26u, anded.count_matching(high));
+
+  auto xored = column;
+  xored ^= low;
+  for (std::size_t i = 0; i != column_size; ++i) {
+    BOOST_TEST_EQ(xored[i], expected[i] ^ low);
+  }
+  BOOST_TEST_EQ(13u, xored.count_matching(low | high));
+
+  auto combined = anded;
+  combined |= xored;
+  combined &= column;
+  combined ^= anded;
+  for (std::size_t i = 0; i != column_size; ++i) {
+    const auto merged = (expected[i] & high) | (expected[i] ^ low);
+    BOOST_TEST_EQ(combined[i], (merged & expected[i]) ^ (expected[i] & high));
+  }
+
+  // column operations stop at the shorter of the two columns:
+  auto prefix = column;
+  prefix.resize(5);
+  prefix |= ored;
+  BOOST_TEST_EQ(5u, prefix.size());
+  BOOST_TEST_EQ(5u, prefix.count_matching(low));
+}
+
+
+int main() {
+  test_container();
+  test_bulk(SmallEnum::SmallOne, SmallEnum::SmallEight);
+  test_bulk(ShortEnum::Low, ShortEnum::High);
+  test_bulk(Enum::One, Enum::Eight);
+  test_bulk(WideEnum::Low, WideEnum::High);
+  return boost::report_errors();
+}
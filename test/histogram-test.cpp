@@ -0,0 +1,88 @@
+#include "common.hpp"
+
+#include <flags/histogram.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Medium : std::uint16_t {};
+ALLOW_FLAGS_FOR_ENUM(Medium)
+
+
+template <class E>
+typename flags::flag_counter<E>::counts_type
+naive_histogram(const std::vector<flags::flags<E>> &values) {
+  typename flags::flag_counter<E>::counts_type counts{};
+  for (auto fl : values) {
+    const auto raw = static_cast<std::uint64_t>(
+      static_cast<typename flags::flags<E>::impl_type>(fl.underlying_value()));
+    for (std::size_t b = 0; b < counts.size(); ++b) {
+      counts[b] += (raw >> b) & 1;
+    }
+  }
+  return counts;
+}
+
+
+template <class E> void check_histogram() {
+  // sizes around blocks and the flushes of the bit-sliced counter
+  for (std::size_t n : {0, 1, 15, 16, 17, 255, 4096, 100000, 300001}) {
+    const auto values = make_values<E>(n);
+    const auto expected = naive_histogram(values);
+    BOOST_TEST(flags::flag_histogram(values.data(), n) == expected);
+
+    const flags::flags_vector<E> column(values.begin(), values.end());
+    BOOST_TEST(flags::flag_histogram(column) == expected);
+  }
+}
+
+
+template <class E> void check_streaming() {
+  const auto values = make_values<E>(50000);
+  flags::flag_counter<E> counter;
+  std::size_t fed = 0;
+  std::mt19937 gen(3);
+  while (fed < values.size()) {
+    const std::size_t chunk = std::min<std::size_t>(gen() % 3000,
+                                                    values.size() - fed);
+    counter.add(values.data() + fed, chunk);
+    fed += chunk;
+  }
+  BOOST_TEST(counter.counts() == naive_histogram(values));
+  BOOST_TEST_EQ(values.size(), counter.total());
+
+  counter.clear();
+  BOOST_TEST_EQ(0u, counter.total());
+  BOOST_TEST_EQ(0u, counter.counts()[0]);
+}
+
+
+void test_single_values() {
+  flags::flag_counter<Enum> counter;
+  counter.add(Enum::One | Enum::Four);
+  counter.add(Enum::Four);
+  const Enums values[] = {Enum::Eight, Enum::Four | Enum::Eight};
+  counter.add(values, 2);
+  BOOST_TEST_EQ(1u, counter.count(Enum::One));
+  BOOST_TEST_EQ(0u, counter.count(Enum::Two));
+  BOOST_TEST_EQ(3u, counter.count(Enum::Four));
+  BOOST_TEST_EQ(2u, counter.count(Enum::Eight));
+  BOOST_TEST_EQ(0u, counter.count(static_cast<Enum>(0)));
+  BOOST_TEST_EQ(4u, counter.total());
+}
+
+
+int main() {
+  check_histogram<SmallEnum>();
+  check_histogram<Medium>();
+  check_histogram<Enum>();
+  check_histogram<Wide>();
+  check_streaming<Medium>();
+  check_streaming<Wide>();
+  test_single_values();
+  return boost::report_errors();
+}
@@ -1,10 +1,18 @@
 #include "common.hpp"
 
+#include <cstdint>
+#include <iterator>
 #include <vector>
 
 #include <boost/core/lightweight_test.hpp>
 
 
+enum class Sparse : unsigned short {Low = 1, Middle = 4, High = 0x100};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Sparse, Low, Middle, High)
+
+using Sparses = flags::flags<Sparse>;
+
+
 namespace flags {
 template <class E>
 auto operator<<(std::ostream& o, flags<E> fl) -> std::ostream& {
@@ -370,6 +378,171 @@ void test_erase_iterator() {
   BOOST_TEST_EQ(8, static_cast<int>(*it2));
 }
 
+void test_iteration() {
+  const Enums none{flags::empty};
+  BOOST_TEST(none.begin() == none.end());
+
+  const Enums sparse(Enum::One, Enum::Eight);
+  std::vector<Enum> visited(sparse.begin(), sparse.end());
+  BOOST_TEST_EQ(2u, visited.size());
+  BOOST_TEST_EQ(1, static_cast<int>(visited[0]));
+  BOOST_TEST_EQ(8, static_cast<int>(visited[1]));
+
+  // the highest bit of impl_type is the last element:
+  const SmallEnum top = static_cast<SmallEnum>(0x80);
+  const SmallEnums small(SmallEnum::SmallTwo, top);
+  auto it = small.begin();
+  BOOST_TEST_EQ(2, static_cast<int>(*it));
+  BOOST_TEST_EQ(0x80, static_cast<int>(*++it));
+  BOOST_TEST(++it == small.end());
+}
+
+void test_reverse_iteration() {
+  const Enums none{flags::empty};
+  BOOST_TEST(none.rbegin() == none.rend());
+
+  const Enums three(Enum::One, Enum::Four, Enum::Eight);
+  std::vector<Enum> visited(three.rbegin(), three.rend());
+  BOOST_TEST_EQ(3u, visited.size());
+  BOOST_TEST(visited[0] == Enum::Eight);
+  BOOST_TEST(visited[2] == Enum::One);
+
+  auto it = three.end();
+  BOOST_TEST(*--it == Enum::Eight);
+  BOOST_TEST(*std::prev(it) == Enum::Four);
+  BOOST_TEST(std::next(three.begin()) == std::prev(it));
+  BOOST_TEST(--three.find(Enum::Four) == three.begin());
+
+  const SmallEnum top = static_cast<SmallEnum>(0x80);
+  BOOST_TEST(*SmallEnums(SmallEnum::SmallOne, top).rbegin() == top);
+}
+
+void test_front_back_nth() {
+  const Enums three(Enum::Two, Enum::Four, Enum::Eight);
+  BOOST_TEST(three.front() == Enum::Two);
+  BOOST_TEST(three.back() == Enum::Eight);
+  BOOST_TEST(three.nth(0) == Enum::Two);
+  BOOST_TEST(three.nth(1) == Enum::Four);
+  BOOST_TEST(three.nth(2) == Enum::Eight);
+
+  const Enums top(static_cast<Enum>(1u << 31));
+  BOOST_TEST(top.back() == static_cast<Enum>(1u << 31));
+  BOOST_TEST(top.nth(0) == top.front());
+
+  // nth against walking the iterator, for every 8-bit value
+  for (unsigned v = 1; v < 256; ++v) {
+    const SmallEnums fl(static_cast<SmallEnum>(v));
+    std::size_t i = 0;
+    for (auto e : fl) { BOOST_TEST(fl.nth(i++) == e); }
+    BOOST_TEST(fl.back() == *fl.rbegin());
+  }
+
+  // the broadword select on 64-bit words
+  std::uint64_t x = 1;
+  for (int round = 0; round < 2000; ++round) {
+    x = x * 6364136223846793005u + 1442695040888963407u;
+    std::uint64_t rest = x;
+    for (unsigned k = 0; rest; ++k, rest &= rest - 1) {
+      BOOST_TEST_EQ(flags::detail::countr_zero(rest),
+                    flags::detail::select_bit(x, k));
+    }
+  }
+  static_assert(flags::detail::select_bit(0x8000000000000101u, 2) == 63, "");
+}
+
+void test_bounds() {
+  const Enums sparse(Enum::One, Enum::Four, Enum::Eight);
+  BOOST_TEST(*sparse.lower_bound(Enum::Four) == Enum::Four);
+  BOOST_TEST(*sparse.lower_bound(Enum::Two) == Enum::Four);
+  BOOST_TEST(*sparse.upper_bound(Enum::Four) == Enum::Eight);
+  BOOST_TEST(*sparse.upper_bound(Enum::Two) == Enum::Four);
+  BOOST_TEST(sparse.upper_bound(Enum::Eight) == sparse.end());
+  BOOST_TEST(sparse.lower_bound(Enum::One) == sparse.begin());
+  BOOST_TEST(--sparse.lower_bound(Enum::Eight) == sparse.find(Enum::Four));
+
+  auto range = sparse.equal_range(Enum::Four);
+  BOOST_TEST(range.first == sparse.find(Enum::Four));
+  BOOST_TEST(std::next(range.first) == range.second);
+  range = sparse.equal_range(Enum::Two);
+  BOOST_TEST(range.first == range.second);
+  BOOST_TEST(*range.first == Enum::Four);
+
+  const auto halves = sparse.split_at(Enum::Four);
+  BOOST_TEST_EQ(halves.first, Enums{Enum::One});
+  BOOST_TEST_EQ(halves.second, Enum::Four | Enum::Eight);
+  BOOST_TEST_EQ(sparse.split_at(Enum::One).first, Enums{flags::empty});
+
+  const SmallEnum top = static_cast<SmallEnum>(0x80);
+  const SmallEnums small(SmallEnum::SmallTwo, top);
+  BOOST_TEST(*small.upper_bound(SmallEnum::SmallTwo) == top);
+  BOOST_TEST_EQ(small.split_at(top).second.underlying_value(), 0x80);
+}
+
+void test_range_erase_and_extract() {
+  // every range of a value, against erasing one flag at a time
+  const SmallEnums value(static_cast<SmallEnum>(0xb6));
+  for (auto i = value.begin(); ; ++i) {
+    for (auto j = i; ; ++j) {
+      SmallEnums expected = value;
+      for (auto k = i; k != j; ++k) { expected.erase(*k); }
+
+      SmallEnums erased = value;
+      const auto next = erased.erase(i, j);
+      BOOST_TEST_EQ(expected.underlying_value(), erased.underlying_value());
+      BOOST_TEST(next == j);
+
+      SmallEnums extracted = value;
+      const auto removed = extracted.extract_range(i, j);
+      BOOST_TEST_EQ(expected.underlying_value(),
+                    extracted.underlying_value());
+      BOOST_TEST_EQ((value ^ expected).underlying_value(),
+                    removed.underlying_value());
+      if (j == value.end()) { break; }
+    }
+    if (i == value.end()) { break; }
+  }
+}
+
+void test_size_and_mask_queries() {
+  const Enums none{flags::empty};
+  BOOST_TEST_EQ(0u, none.size());
+
+  const Enums three(Enum::One, Enum::Four, Enum::Eight);
+  BOOST_TEST_EQ(3u, three.size());
+
+  const SmallEnums full = ~SmallEnums{flags::empty};
+  BOOST_TEST_EQ(8u, full.size());
+
+  const Enums mask(Enum::One, Enum::Two);
+  BOOST_TEST_EQ(1u, three.count_in(mask));
+  BOOST_TEST(three.any_of(mask));
+  BOOST_TEST_NOT(three.all_of(mask));
+  BOOST_TEST_NOT(three.none_of(mask));
+
+  BOOST_TEST(three.all_of(Enum::Four | Enum::Eight));
+  BOOST_TEST(three.none_of(Enum::Two));
+  BOOST_TEST(three.all_of(none));
+  BOOST_TEST_NOT(three.any_of(none));
+}
+
+void test_valid_values() {
+  BOOST_TEST_EQ(Sparses::all(), Sparse::Low | Sparse::Middle | Sparse::High);
+  BOOST_TEST_EQ(3u, Sparses{flags::empty}.max_size());
+  BOOST_TEST_EQ(~Sparses{Sparse::Low}, Sparse::Middle | Sparse::High);
+  BOOST_TEST_EQ(~Sparses::all(), Sparses{flags::empty});
+
+  const auto complement = ~Sparses{Sparse::Middle};
+  std::vector<Sparse> visited(complement.begin(), complement.end());
+  BOOST_TEST_EQ(2u, visited.size());
+  BOOST_TEST(visited[0] == Sparse::Low);
+  BOOST_TEST(visited[1] == Sparse::High);
+
+  // enums without a list of values keep every bit valid
+  BOOST_TEST_EQ(Enums::all().underlying_value(), -1);
+  BOOST_TEST_EQ(Enums::bit_size(), Enums{flags::empty}.max_size());
+}
+
+
 int main() {
   test_set_underlying_value();
   test_empty_constructor();
@@ -385,5 +558,12 @@ int main() {
   test_bitset();
   test_erase();
   test_erase_iterator();
+  test_iteration();
+  test_reverse_iteration();
+  test_front_back_nth();
+  test_bounds();
+  test_range_erase_and_extract();
+  test_size_and_mask_queries();
+  test_valid_values();
   return boost::report_errors();
 }
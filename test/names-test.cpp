@@ -0,0 +1,177 @@
+#if defined(__has_include)
+#  if __has_include(<fmt/format.h>)
+#    define FMT_HEADER_ONLY
+#    include <fmt/format.h>
+#  endif
+#endif
+
+#include <flags/names.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Permission : unsigned char {Read = 1, Write = 2, Exec = 4,
+                                       ReadWrite = 3, Admin = 0x20};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Permission, Read, Write, Exec, ReadWrite, Admin)
+
+using Permissions = flags::flags<Permission>;
+
+
+// similar names, all 64 bits
+enum class Many : unsigned long long {
+  Name0 = 1ull << 0, Name1 = 1ull << 1, Name2 = 1ull << 2, Name3 = 1ull << 3,
+  Name4 = 1ull << 4, Name5 = 1ull << 5, Name6 = 1ull << 6, Name7 = 1ull << 7,
+  Name8 = 1ull << 8, Name9 = 1ull << 9, Name10 = 1ull << 10,
+  Name11 = 1ull << 11, Name12 = 1ull << 12, Name13 = 1ull << 13,
+  Name14 = 1ull << 14, Name15 = 1ull << 15, Name16 = 1ull << 16,
+  Name17 = 1ull << 17, Name18 = 1ull << 18, Name19 = 1ull << 19,
+  Name20 = 1ull << 20, Name21 = 1ull << 21, Name22 = 1ull << 22,
+  Name23 = 1ull << 23, Name24 = 1ull << 24, Name25 = 1ull << 25,
+  Name26 = 1ull << 26, Name27 = 1ull << 27, Name28 = 1ull << 28,
+  Name29 = 1ull << 29, Name30 = 1ull << 30, Name31 = 1ull << 31,
+  Name32 = 1ull << 32, Name33 = 1ull << 33, Name34 = 1ull << 34,
+  Name35 = 1ull << 35, Name36 = 1ull << 36, Name37 = 1ull << 37,
+  Name38 = 1ull << 38, Name39 = 1ull << 39, Name40 = 1ull << 40,
+  Name41 = 1ull << 41, Name42 = 1ull << 42, Name43 = 1ull << 43,
+  Name44 = 1ull << 44, Name45 = 1ull << 45, Name46 = 1ull << 46,
+  Name47 = 1ull << 47, Name48 = 1ull << 48, Name49 = 1ull << 49,
+  Name50 = 1ull << 50, Name51 = 1ull << 51, Name52 = 1ull << 52,
+  Name53 = 1ull << 53, Name54 = 1ull << 54, Name55 = 1ull << 55,
+  Name56 = 1ull << 56, Name57 = 1ull << 57, Name58 = 1ull << 58,
+  Name59 = 1ull << 59, Name60 = 1ull << 60, Name61 = 1ull << 61,
+  Name62 = 1ull << 62, Name63 = 1ull << 63};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Many,
+  Name0, Name1, Name2, Name3, Name4, Name5, Name6, Name7, Name8, Name9, Name10,
+  Name11, Name12, Name13, Name14, Name15, Name16, Name17, Name18, Name19,
+  Name20, Name21, Name22, Name23, Name24, Name25, Name26, Name27, Name28,
+  Name29, Name30, Name31, Name32, Name33, Name34, Name35, Name36, Name37,
+  Name38, Name39, Name40, Name41, Name42, Name43, Name44, Name45, Name46,
+  Name47, Name48, Name49, Name50, Name51, Name52, Name53, Name54, Name55,
+  Name56, Name57, Name58, Name59, Name60, Name61, Name62, Name63)
+
+
+enum class Plain : unsigned {One = 1, Two = 2};
+ALLOW_FLAGS_FOR_ENUM(Plain)
+
+
+template <class E>
+std::string format(flags::flags<E> fl, char delimiter = '|') {
+  char buffer[flags::max_chars<E>()];
+  const auto result = flags::to_chars(buffer, buffer + sizeof(buffer), fl,
+                                      delimiter);
+  BOOST_TEST(result.ec == std::errc{});
+  return std::string(buffer, result.ptr);
+}
+
+template <class E>
+flags::from_chars_result parse(const std::string &s, flags::flags<E> &fl,
+                               char delimiter = '|') {
+  return flags::from_chars(s.data(), s.data() + s.size(), fl, delimiter);
+}
+
+
+void test_to_chars() {
+  BOOST_TEST_EQ("Read", format(Permissions{Permission::Read}));
+  BOOST_TEST_EQ("Read|Write|Exec",
+                format(Permission::Exec | Permission::ReadWrite));
+  BOOST_TEST_EQ("0", format(Permissions{flags::empty}));
+  BOOST_TEST_EQ("Write,Admin",
+                format(Permission::Admin | Permission::Write, ','));
+
+  Permissions unnamed{flags::empty};
+  unnamed.set_underlying_value(0x41);
+  BOOST_TEST_EQ("Read|0x40", format(unnamed));
+  BOOST_TEST_EQ("0x2", format(Plain::Two | Plain::Two));
+
+  char small[6];
+  const auto result = flags::to_chars(small, small + sizeof(small),
+                                      Permission::Read | Permission::Exec);
+  BOOST_TEST(result.ec == std::errc::value_too_large);
+  BOOST_TEST(result.ptr == small + sizeof(small));
+}
+
+
+void test_from_chars() {
+  Permissions fl{flags::empty};
+  BOOST_TEST(parse("Exec|Read", fl).ec == std::errc{});
+  BOOST_TEST_EQ(fl, Permission::Read | Permission::Exec);
+
+  BOOST_TEST(parse("ReadWrite|Admin", fl).ec == std::errc{});
+  BOOST_TEST_EQ(fl, Permission::ReadWrite | Permission::Admin);
+
+  BOOST_TEST(parse("0", fl).ec == std::errc{});
+  BOOST_TEST(fl.empty());
+
+  BOOST_TEST(parse("Write;0x40", fl, ';').ec == std::errc{});
+  BOOST_TEST_EQ(0x42, fl.underlying_value());
+
+  const std::string bad = "Read|Wrte|Exec";
+  const auto result = parse(bad, fl);
+  BOOST_TEST(result.ec == std::errc::invalid_argument);
+  BOOST_TEST_EQ(5, result.ptr - bad.data());
+  BOOST_TEST_EQ(0x42, fl.underlying_value());
+
+  BOOST_TEST(parse("", fl).ec == std::errc::invalid_argument);
+  BOOST_TEST(parse("Read|", fl).ec == std::errc::invalid_argument);
+  BOOST_TEST(parse("Rea", fl).ec == std::errc::invalid_argument);
+  BOOST_TEST(parse("Reads", fl).ec == std::errc::invalid_argument);
+  BOOST_TEST(parse("0x100", fl).ec == std::errc::invalid_argument);
+  BOOST_TEST(parse("0xg", fl).ec == std::errc::invalid_argument);
+
+  flags::flags<Plain> plain{flags::empty};
+  BOOST_TEST(parse("0x3", plain).ec == std::errc{});
+  BOOST_TEST_EQ(2u, plain.size());
+  BOOST_TEST(parse("One", plain).ec == std::errc::invalid_argument);
+}
+
+
+void test_round_trip() {
+  for (unsigned v = 0; v != 256; ++v) {
+    Permissions fl{flags::empty};
+    fl.set_underlying_value(static_cast<unsigned char>(v));
+    Permissions parsed{flags::empty};
+    BOOST_TEST(parse(format(fl), parsed).ec == std::errc{});
+    BOOST_TEST_EQ(fl.underlying_value(), parsed.underlying_value());
+  }
+}
+
+
+void test_many_names() {
+  for (unsigned n = 0; n != 64; ++n) {
+    const std::string name = "Name" + std::to_string(n);
+    flags::flags<Many> fl{flags::empty};
+    BOOST_TEST(parse(name, fl).ec == std::errc{});
+    BOOST_TEST_EQ(1ull << n, fl.underlying_value());
+    BOOST_TEST_EQ(name, format(fl));
+  }
+  flags::flags<Many> fl{flags::empty};
+  BOOST_TEST(parse("Name64", fl).ec == std::errc::invalid_argument);
+  BOOST_TEST(parse("Name0|Name63", fl).ec == std::errc{});
+  BOOST_TEST_EQ(2u, fl.size());
+}
+
+
+void test_streams_and_fmt() {
+  std::ostringstream out;
+  out << (Permission::Write | Permission::Admin);
+  BOOST_TEST_EQ("Write|Admin", out.str());
+
+#ifdef FMT_VERSION
+  BOOST_TEST_EQ("[Read|Exec]",
+                fmt::format("[{}]", Permission::Read | Permission::Exec));
+#endif
+}
+
+
+int main() {
+  test_to_chars();
+  test_from_chars();
+  test_round_trip();
+  test_many_names();
+  test_streams_and_fmt();
+  return boost::report_errors();
+}
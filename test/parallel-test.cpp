@@ -0,0 +1,155 @@
+#include "common.hpp"
+
+#include <flags/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Narrow : std::uint8_t {};
+ALLOW_FLAGS_FOR_ENUM(Narrow)
+
+
+void test_parallel_for() {
+  for (std::size_t threads : {1, 2, 5}) {
+    flags::thread_pool pool(threads);
+    BOOST_TEST_EQ(threads, pool.concurrency());
+
+    for (std::size_t chunks : {0, 1, 3, 1000}) {
+      std::vector<std::atomic<int>> calls(chunks);
+      for (auto &c : calls) { c = 0; }
+      pool.parallel_for(chunks, [&](std::size_t i) {
+        // uneven chunks, so that threads run out and steal
+        volatile std::size_t spin = i % 7 * 1000;
+        while (spin) { spin = spin - 1; }
+        ++calls[i];
+      });
+      for (auto &c : calls) { BOOST_TEST_EQ(1, c.load()); }
+    }
+  }
+}
+
+
+// Runs every algorithm with policy and checks it against plain loops.
+template <class E, class Policy>
+void check_algorithms(const Policy &policy, std::size_t n) {
+  using flags_type = flags::flags<E>;
+  const auto values = make_values<E>(n);
+  const flags_type mask = from_raw<E>(0x5a5a5a5a5a5a5a5aull);
+
+  auto expected = values;
+  auto actual = values;
+  for (auto &fl : expected) { fl |= mask; }
+  flags::transform_or(policy, actual.data(), actual.data() + n, mask);
+  BOOST_TEST(actual == expected);
+  for (auto &fl : expected) { fl &= ~mask | from_raw<E>(1); }
+  flags::transform_and(policy, actual.data(), actual.data() + n,
+                       ~mask | from_raw<E>(1));
+  BOOST_TEST(actual == expected);
+  for (auto &fl : expected) { fl ^= mask; }
+  flags::transform_xor(policy, actual.data(), actual.data() + n, mask);
+  BOOST_TEST(actual == expected);
+
+  flags_type any{flags::empty};
+  flags_type all = flags_type::all();
+  for (auto fl : values) {
+    any |= fl;
+    all &= fl;
+  }
+  BOOST_TEST(flags::reduce_or(policy, values.data(), values.data() + n)
+             == any);
+  BOOST_TEST(flags::reduce_and(policy, values.data(), values.data() + n)
+             == all);
+
+  const flags::predicate<E> superset{from_raw<E>(0x3)};
+  const auto p = superset.without(from_raw<E>(0x10))
+                         .with_any_of(from_raw<E>(0xc0));
+  for (const auto &q : {superset, p}) {
+    BOOST_TEST_EQ(static_cast<std::size_t>(
+                    std::count_if(values.begin(), values.end(), q)),
+                  flags::count_if(policy, values.data(), values.data() + n,
+                                  q));
+
+    auto partitioned = values;
+    std::vector<flags_type> buffer(n);
+    const auto middle = flags::partition_by(policy, partitioned.data(),
+                                            partitioned.data() + n,
+                                            buffer.data(), q);
+    auto reference = values;
+    std::stable_partition(reference.begin(), reference.end(), q);
+    BOOST_TEST(partitioned == reference);
+    BOOST_TEST_EQ(middle - partitioned.data(),
+                  std::count_if(values.begin(), values.end(), q));
+  }
+}
+
+
+template <class E> void check_widths(std::size_t n) {
+  flags::thread_pool pool(3);
+  check_algorithms<E>(flags::execution::seq, n);
+  check_algorithms<E>(flags::execution::par, n);
+  check_algorithms<E>(flags::execution::par.on(pool), n);
+  // chunks of 128 elements, a partial one last
+  check_algorithms<E>(flags::execution::par.on(pool).with_chunk_size(100),
+                      n);
+#ifdef ENUM_CLASS_FLAGS_HAS_EXECUTION_POLICIES
+  check_algorithms<E>(std::execution::seq, n);
+  check_algorithms<E>(std::execution::par_unseq, n);
+#endif
+}
+
+void test_algorithms() {
+  for (std::size_t n : {0, 1, 63, 1000, 20000}) {
+    check_widths<Wide>(n);
+    check_widths<Narrow>(n);
+    check_widths<Enum>(n);
+  }
+}
+
+
+void test_flags_vector() {
+  flags::flags_vector<Enum> column(1000, Enum::One | Enum::Four);
+  column.set(10, Enum::Two);
+  const auto policy = flags::execution::par.with_chunk_size(64);
+
+  flags::transform_or(policy, column, Enums{Enum::Eight});
+  BOOST_TEST_EQ(1000u, flags::count_if(policy, column,
+                                       flags::predicate<Enum>{Enum::Eight}));
+  BOOST_TEST(flags::reduce_and(policy, column) == Enum::Eight);
+  BOOST_TEST(flags::reduce_or(policy, column)
+             == (Enum::One | Enum::Two | Enum::Four | Enum::Eight));
+
+  flags::transform_xor(policy, column, Enums{Enum::Four});
+  flags::transform_and(policy, column, Enum::Two | Enum::Four);
+  BOOST_TEST(flags::reduce_or(policy, column) == (Enum::Two | Enum::Four));
+  BOOST_TEST_EQ(1u, flags::count_if(policy, column,
+                                    flags::predicate<Enum>{Enum::Two}));
+
+  const auto values = make_values<Enum>(3000, 4);
+  flags::flags_vector<Enum> partitioned(values.begin(), values.end());
+  const flags::predicate<Enum> two{Enum::Two};
+  auto expected = values;
+  const auto middle = std::stable_partition(expected.begin(), expected.end(),
+                                            two);
+  BOOST_TEST_EQ(static_cast<std::size_t>(middle - expected.begin()),
+                flags::partition_by(policy, partitioned, two));
+  BOOST_TEST(std::equal(expected.begin(), expected.end(),
+                        partitioned.begin()));
+
+  // only policies pick the overloads above
+  BOOST_TEST(flags::is_execution_policy<flags::execution::parallel_policy>
+               ::value);
+  BOOST_TEST(!flags::is_execution_policy<int>::value);
+}
+
+
+int main() {
+  test_parallel_for();
+  test_algorithms();
+  test_flags_vector();
+  return boost::report_errors();
+}
@@ -0,0 +1,134 @@
+#include <flags/parse.hpp>
+
+#include <string>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Permission : unsigned short {Read = 1, Write = 2, Exec = 4,
+                                        Delete = 8, Admin = 0x100};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Permission, Read, Write, Exec, Delete, Admin)
+
+using Permissions = flags::flags<Permission>;
+
+
+const Permissions samples[] = {
+  Permission::Read,
+  Permission::Read | Permission::Write,
+  Permissions{flags::empty},
+  Permission::Exec | Permission::Delete | Permission::Admin,
+  Permission::Write | Permission::Admin,
+};
+
+// Record i of the text is samples[i % 5], written as names.
+std::string make_records(std::size_t n, char delimiter = '|',
+                         char separator = '\n') {
+  std::string text;
+  for (std::size_t i = 0; i < n; ++i) {
+    char buffer[flags::max_chars<Permission>()];
+    const auto r = flags::to_chars(buffer, buffer + sizeof(buffer),
+                                   samples[i % 5], delimiter);
+    text.append(buffer, r.ptr);
+    text += separator;
+  }
+  return text;
+}
+
+
+void test_records() {
+  // long enough for several 64-byte blocks and a scalar tail
+  const std::size_t n = 203;
+  const std::string text = make_records(n);
+  std::vector<Permissions> out(n + 1, Permissions{flags::empty});
+
+  const auto r = flags::parse_records(text.data(), text.data() + text.size(),
+                                      out.data(), out.size());
+  BOOST_TEST(r.ptr == text.data() + text.size());
+  BOOST_TEST_EQ(n, r.records);
+  BOOST_TEST_EQ(0u, r.errors);
+  for (std::size_t i = 0; i < n; ++i) { BOOST_TEST(samples[i % 5] == out[i]); }
+}
+
+
+void test_final_record_and_separators() {
+  const std::string text = "Read\nWrite|Exec";
+  Permissions out[3];
+
+  auto r = flags::parse_records(text.data(), text.data() + text.size(), out,
+                                3);
+  BOOST_TEST_EQ(2u, r.records);
+  BOOST_TEST(out[1] == (Permission::Write | Permission::Exec));
+
+  const std::string csv = make_records(100, ',', ';');
+  std::vector<Permissions> parsed(100);
+  r = flags::parse_records(csv.data(), csv.data() + csv.size(), parsed.data(),
+                           parsed.size(), nullptr, 0, ',', ';');
+  BOOST_TEST_EQ(100u, r.records);
+  BOOST_TEST_EQ(0u, r.errors);
+  BOOST_TEST(samples[99 % 5] == parsed[99]);
+
+  r = flags::parse_records(text.data(), text.data(), out, 3);
+  BOOST_TEST_EQ(0u, r.records);
+}
+
+
+void test_capacity() {
+  const std::string text = make_records(150);
+  std::vector<Permissions> out(64);
+
+  // parse in chunks, resuming where the previous call stopped
+  const char *first = text.data();
+  const char *last = text.data() + text.size();
+  std::size_t total = 0;
+  while (first != last) {
+    const auto r = flags::parse_records(first, last, out.data(), out.size());
+    for (std::size_t i = 0; i < r.records; ++i) {
+      BOOST_TEST(samples[(total + i) % 5] == out[i]);
+    }
+    total += r.records;
+    first = r.ptr;
+  }
+  BOOST_TEST_EQ(150u, total);
+
+  const auto r = flags::parse_records(text.data(), last, out.data(), 0);
+  BOOST_TEST_EQ(0u, r.records);
+  BOOST_TEST(r.ptr == text.data());
+}
+
+
+void test_errors() {
+  std::string text = make_records(80);
+  const std::size_t bad = text.size();
+  text += "Read|Wirte|Bogus\n";
+  text += "\n";
+  text += make_records(80);
+  text += "0x100|0xzz";
+
+  std::vector<Permissions> out(200);
+  flags::record_error errors[2];
+  const auto r = flags::parse_records(text.data(), text.data() + text.size(),
+                                      out.data(), out.size(), errors, 2);
+  BOOST_TEST_EQ(163u, r.records);
+  BOOST_TEST_EQ(3u, r.errors);
+
+  BOOST_TEST_EQ(80u, errors[0].record);
+  BOOST_TEST_EQ(bad + 5, errors[0].position);
+  BOOST_TEST(out[80] == Permission::Read);
+
+  // an empty record
+  BOOST_TEST_EQ(81u, errors[1].record);
+  BOOST_TEST(out[81] == Permissions{flags::empty});
+
+  BOOST_TEST(samples[79 % 5] == out[161]);
+  BOOST_TEST(out[162] == Permission::Admin);
+}
+
+
+int main() {
+  test_records();
+  test_final_record_and_separators();
+  test_capacity();
+  test_errors();
+  return boost::report_errors();
+}
@@ -0,0 +1,89 @@
+#include <flags/published_flags.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Feature : unsigned short { First = 0, Word = 64, Last = 299 };
+ALLOW_WIDE_FLAGS_FOR_ENUM(Feature)
+
+using Features = flags::wide_flags<Feature, 300>;
+
+
+// Every third feature, starting at the k-th.
+Features pattern(unsigned k) {
+  Features fl{flags::empty};
+  for (unsigned i = k % 3; i < 300; i += 3) {
+    fl.insert(static_cast<Feature>(i));
+  }
+  return fl;
+}
+
+
+void test_publish() {
+  flags::published_flags<Feature, 300> published;
+  BOOST_TEST(published.load().empty());
+  BOOST_TEST_EQ(0u, published.version());
+
+  published.publish(Features{Feature::First, Feature::Last});
+  BOOST_TEST(published.load() == Features(Feature::First, Feature::Last));
+  BOOST_TEST_EQ(1u, published.version());
+
+  published.insert(Feature::Word);
+  published.erase(Feature::First);
+  const Features fl = published;
+  BOOST_TEST(fl == Features(Feature::Word, Feature::Last));
+
+  const Features all = published.update([](Features current) {
+    return ~current | current;
+  });
+  BOOST_TEST_EQ(300u, all.size());
+  BOOST_TEST(published.load() == all);
+  BOOST_TEST_EQ(4u, published.version());
+
+  const flags::published_flags<Feature, 300> initial{pattern(1), 3};
+  BOOST_TEST(initial.load() == pattern(1));
+  BOOST_TEST_EQ(4u, initial.slot_count());
+}
+
+
+// Readers never see a mix of two published sets, nor a deleted one, with
+// a slot per reader or one shared by all.
+void test_no_torn_reads(std::size_t slots) {
+  flags::published_flags<Feature, 300> published{pattern(0), slots};
+  const Features patterns[3] = {pattern(0), pattern(1), pattern(2)};
+  std::atomic<bool> done{false};
+  std::atomic<unsigned> torn{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        const Features fl = published.load();
+        if (fl != patterns[0] && fl != patterns[1] && fl != patterns[2]) {
+          ++torn;
+        }
+      }
+    });
+  }
+  for (unsigned k = 1; k <= 20000; ++k) {
+    published.publish(patterns[k % 3]);
+  }
+  done = true;
+  for (auto &reader : readers) { reader.join(); }
+
+  BOOST_TEST_EQ(0u, torn.load());
+  BOOST_TEST_EQ(20000u, published.version());
+  BOOST_TEST(published.load() == patterns[20000 % 3]);
+}
+
+
+int main() {
+  test_publish();
+  test_no_torn_reads(flags::published_flags<Feature, 300>::default_slots());
+  test_no_torn_reads(1);
+  return boost::report_errors();
+}
@@ -0,0 +1,168 @@
+#include "common.hpp"
+
+#include <flags/query.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class WideEnum : std::uint64_t {Low = 1, Middle = 1ull << 31,
+                                     High = 1ull << 63};
+ALLOW_FLAGS_FOR_ENUM(WideEnum)
+
+enum class ShortEnum : std::uint16_t {Low = 1, Middle = 1u << 8,
+                                      High = 1u << 15};
+ALLOW_FLAGS_FOR_ENUM(ShortEnum)
+
+
+// Not a multiple of 64, nor of any vector width, so that every kernel has
+// a partial last word and a scalar tail.
+constexpr std::size_t column_size = 203;
+
+
+template <class E>
+flags::flags_vector<E> make_column(E a, E b, E c) {
+  flags::flags_vector<E> column;
+  for (std::size_t i = 0; i != column_size; ++i) {
+    flags::flags<E> fl{flags::empty};
+    if (i % 2) fl |= a;
+    if (i % 3) fl |= b;
+    if (i % 5 == 0) fl |= c;
+    column.push_back(fl);
+  }
+  return column;
+}
+
+
+template <class E>
+void check_selection(const flags::flags_vector<E> &column,
+                     const std::vector<std::uint64_t> &bitmap,
+                     const std::vector<bool> &expected) {
+  std::size_t expected_size = 0;
+  for (std::size_t i = 0; i != column.size(); ++i) {
+    BOOST_TEST_EQ(expected[i], ((bitmap[i / 64] >> (i % 64)) & 1) != 0);
+    expected_size += expected[i];
+  }
+  BOOST_TEST_EQ(0u, bitmap.back() >> (column.size() % 64));
+  BOOST_TEST_EQ(expected_size,
+                flags::selection_size(bitmap.data(), column.size()));
+
+  std::vector<std::size_t> indices(column.size());
+  const auto count = flags::selection_indices(bitmap.data(), column.size(),
+                                              indices.data());
+  BOOST_TEST_EQ(expected_size, count);
+  for (std::size_t k = 0; k != count; ++k) {
+    BOOST_TEST(expected[indices[k]]);
+    if (k) BOOST_TEST_LT(indices[k - 1], indices[k]);
+  }
+}
+
+
+template <class E>
+void test_predicates(E a, E b, E c) {
+  const auto column = make_column(a, b, c);
+  const auto p = flags::predicate<E>{}.with(a).without(c);
+  const auto q = flags::predicate<E>{}.with_any_of(b | c);
+  const flags::predicate<E> everything;
+
+  std::vector<bool> expected(column_size);
+  std::vector<std::uint64_t> bitmap(flags::selection_words(column_size));
+
+  flags::select(column, everything, bitmap.data());
+  for (std::size_t i = 0; i != column_size; ++i) expected[i] = true;
+  check_selection(column, bitmap, expected);
+
+  flags::select(column, p, bitmap.data());
+  for (std::size_t i = 0; i != column_size; ++i) expected[i] = p(column[i]);
+  check_selection(column, bitmap, expected);
+
+  flags::refine(column, q, bitmap.data());
+  for (std::size_t i = 0; i != column_size; ++i) {
+    expected[i] = p(column[i]) && q(column[i]);
+  }
+  check_selection(column, bitmap, expected);
+
+  const flags::predicate<E> only_c{c, a | b};
+  flags::extend(column, only_c, bitmap.data());
+  for (std::size_t i = 0; i != column_size; ++i) {
+    expected[i] = expected[i] || only_c(column[i]);
+  }
+  check_selection(column, bitmap, expected);
+
+  std::vector<std::size_t> indices(column_size);
+  const auto count = flags::select_indices(column, p, indices.data());
+  std::size_t k = 0;
+  for (std::size_t i = 0; i != column_size; ++i) {
+    if (p(column[i])) {
+      BOOST_TEST_EQ(i, indices[k]);
+      ++k;
+    }
+  }
+  BOOST_TEST_EQ(k, count);
+}
+
+
+// The pointer overloads over a plain array give the column results.
+template <class E>
+void test_arrays(E a, E b, E c) {
+  const auto column = make_column(a, b, c);
+  const std::vector<flags::flags<E>> values(column.begin(), column.end());
+  const auto p = flags::predicate<E>{}.with(a).without(c);
+  const auto q = flags::predicate<E>{}.with_any_of(b | c);
+
+  const std::size_t words = flags::selection_words(column_size);
+  std::vector<std::uint64_t> expected(words, ~0ull);
+  std::vector<std::uint64_t> actual(words, ~0ull);
+  flags::select(column, p, expected.data());
+  flags::select(values.data(), values.size(), p, actual.data());
+  BOOST_TEST(actual == expected);
+  flags::extend(column, q, expected.data());
+  flags::extend(values.data(), values.size(), q, actual.data());
+  BOOST_TEST(actual == expected);
+  flags::refine(column, p, expected.data());
+  flags::refine(values.data(), values.size(), p, actual.data());
+  BOOST_TEST(actual == expected);
+
+  std::vector<std::size_t> column_indices(column_size);
+  std::vector<std::size_t> array_indices(column_size);
+  const auto count = flags::select_indices(column, q, column_indices.data());
+  BOOST_TEST_EQ(count, flags::select_indices(values.data(), values.size(), q,
+                                             array_indices.data()));
+  BOOST_TEST(column_indices == array_indices);
+
+  // an empty array leaves out untouched
+  BOOST_TEST_EQ(0u, flags::select_indices(values.data(), 0, q,
+                                          array_indices.data()));
+}
+
+
+void test_single_value() {
+  constexpr auto p = flags::predicate<Enum>{}.with(Enum::One)
+                                             .without(Enum::Two)
+                                             .with_any_of(Enum::Four
+                                                          | Enum::Eight);
+  BOOST_TEST(p(Enum::One | Enum::Four));
+  BOOST_TEST(p(Enum::One | Enum::Four | Enum::Eight));
+  BOOST_TEST_NOT(p(Enums{Enum::One}));
+  BOOST_TEST_NOT(p(Enum::One | Enum::Two | Enum::Four));
+  BOOST_TEST_NOT(p(Enums{Enum::Four}));
+  BOOST_TEST(flags::predicate<Enum>{}(Enums{flags::empty}));
+}
+
+
+int main() {
+  test_single_value();
+  test_predicates(SmallEnum::SmallOne, SmallEnum::SmallTwo,
+                  SmallEnum::SmallEight);
+  test_predicates(ShortEnum::Low, ShortEnum::Middle, ShortEnum::High);
+  test_predicates(Enum::One, Enum::Four, Enum::Eight);
+  test_predicates(WideEnum::Low, WideEnum::Middle, WideEnum::High);
+  test_arrays(SmallEnum::SmallOne, SmallEnum::SmallTwo,
+              SmallEnum::SmallEight);
+  test_arrays(ShortEnum::Low, ShortEnum::Middle, ShortEnum::High);
+  test_arrays(Enum::One, Enum::Four, Enum::Eight);
+  test_arrays(WideEnum::Low, WideEnum::Middle, WideEnum::High);
+  return boost::report_errors();
+}
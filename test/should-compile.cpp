@@ -32,8 +32,8 @@ static_assert(std::is_same<Enums::const_iterator, Iterator>::value,
 static_assert(std::is_same<Iterator::flags_type, Enums>::value,
               "Enums::iterator::flags_type is not Enums!");
 static_assert(std::is_same<Iterator::iterator_category,
-                           std::forward_iterator_tag>::value,
-              "Enums::iterator category is not forward iterator!");
+                           std::bidirectional_iterator_tag>::value,
+              "Enums::iterator category is not bidirectional iterator!");
 static_assert(std::is_same<Iterator::value_type, Enum>::value,
               "Enums::iterator::value_type is not Enum!");
 static_assert(std::is_same<Iterator::reference, const Enum>::value,
@@ -145,6 +145,104 @@ constexpr bool cf1 = ec1.empty();
 constexpr Enums::size_type cf2 = ec1.max_size();
 constexpr Enums::iterator cf3 = ec1.find(Enum::One);
 constexpr Enums::size_type cf4 = ec1.count(Enum::One);
+constexpr Enums::size_type cf5 = ec1.size();
+constexpr Enums::size_type cf6 = ec1.count_in(Enum::One);
+constexpr bool cf7 = ec1.any_of(Enum::One);
+constexpr bool cf8 = ec1.all_of(Enum::One);
+constexpr bool cf9 = ec1.none_of(Enum::One);
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_CONSTEXPR14
+// constexpr mutation (C++14)
+constexpr Enums mutate() {
+  Enums fl{Enum::One, Enum::Two};
+  fl |= Enum::Four;
+  fl &= ~Enums{Enum::Two};
+  fl ^= Enum::Eight;
+  fl.insert(Enum::Two);
+  fl.erase(Enum::One);
+
+  auto i = fl.begin();
+  ++i;
+  fl.erase(i);
+
+  Enums other{flags::empty};
+  other.swap(fl);
+  Enums ranged(other.begin(), other.end());
+  ranged.erase(ranged.find(Enum::Eight), ranged.end());
+  ranged.insert(Enum::Eight);
+  return ranged;
+}
+
+constexpr Enums m1 = mutate();
+static_assert(m1 == (Enum::Two | Enum::Eight),
+              "constexpr mutation gave the wrong result!");
+
+struct Table { Enums masks[4]; };
+
+constexpr Table make_table() {
+  Table table{};
+  for (int i = 0; i != 4; ++i) {
+    table.masks[i].set_underlying_value(1 << i);
+    table.masks[i] |= Enum::One;
+  }
+  table.masks[0].clear();
+  return table;
+}
+
+constexpr Table m2 = make_table();
+static_assert(m2.masks[0].empty() && m2.masks[3].size() == 2,
+              "constexpr table has the wrong contents!");
+
+constexpr Enums::size_type count_by_iteration(Enums fl) {
+  Enums::size_type count = 0;
+  for (auto i = fl.begin(); i != fl.end(); i++) { ++count; }
+  return count;
+}
+
+static_assert(count_by_iteration(m1) == m1.size(),
+              "constexpr iteration gave the wrong count!");
+#endif
+
+
+// enumerator lists
+enum class Few : unsigned char {A = 1, B = 2, C = 64};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Few, A, B, C)
+
+constexpr auto r1 = flags::flags<Few>::all();
+static_assert(r1.underlying_value() == 67, "all() is not the enumerators!");
+constexpr auto r2 = ~flags::flags<Few>(Few::A);
+static_assert(r2.underlying_value() == 66,
+              "operator~ is not bounded by the enumerators!");
+constexpr auto r3 = r2.max_size();
+static_assert(r3 == 3, "max_size() is not the number of enumerators!");
+
+enum class Many : unsigned long long {
+  V0 = 1ull << 0, V1 = 1ull << 1, V2 = 1ull << 2, V3 = 1ull << 3,
+  V4 = 1ull << 4, V5 = 1ull << 5, V6 = 1ull << 6, V7 = 1ull << 7,
+  V8 = 1ull << 8, V9 = 1ull << 9, V10 = 1ull << 10, V11 = 1ull << 11,
+  V12 = 1ull << 12, V13 = 1ull << 13, V14 = 1ull << 14, V15 = 1ull << 15,
+  V16 = 1ull << 16, V17 = 1ull << 17, V18 = 1ull << 18, V19 = 1ull << 19,
+  V20 = 1ull << 20, V21 = 1ull << 21, V22 = 1ull << 22, V23 = 1ull << 23,
+  V24 = 1ull << 24, V25 = 1ull << 25, V26 = 1ull << 26, V27 = 1ull << 27,
+  V28 = 1ull << 28, V29 = 1ull << 29, V30 = 1ull << 30, V31 = 1ull << 31,
+  V32 = 1ull << 32, V33 = 1ull << 33, V34 = 1ull << 34, V35 = 1ull << 35,
+  V36 = 1ull << 36, V37 = 1ull << 37, V38 = 1ull << 38, V39 = 1ull << 39,
+  V40 = 1ull << 40, V41 = 1ull << 41, V42 = 1ull << 42, V43 = 1ull << 43,
+  V44 = 1ull << 44, V45 = 1ull << 45, V46 = 1ull << 46, V47 = 1ull << 47,
+  V48 = 1ull << 48, V49 = 1ull << 49, V50 = 1ull << 50, V51 = 1ull << 51,
+  V52 = 1ull << 52, V53 = 1ull << 53, V54 = 1ull << 54, V55 = 1ull << 55,
+  V56 = 1ull << 56, V57 = 1ull << 57, V58 = 1ull << 58, V59 = 1ull << 59,
+  V60 = 1ull << 60, V61 = 1ull << 61, V62 = 1ull << 62, V63 = 1ull << 63};
+ALLOW_FLAGS_FOR_ENUM_VALUES(Many,
+  V0, V1, V2, V3, V4, V5, V6, V7, V8, V9, V10, V11, V12, V13, V14, V15, V16,
+  V17, V18, V19, V20, V21, V22, V23, V24, V25, V26, V27, V28, V29, V30, V31,
+  V32, V33, V34, V35, V36, V37, V38, V39, V40, V41, V42, V43, V44, V45, V46,
+  V47, V48, V49, V50, V51, V52, V53, V54, V55, V56, V57, V58, V59, V60, V61,
+  V62, V63)
+
+static_assert(flags::flags<Many>::all().size() == 64,
+              "ALLOW_FLAGS_FOR_ENUM_VALUES does not take 64 enumerators!");
 
 
 // non-int underlying type with bitwise operators
@@ -159,6 +257,7 @@ template <class... Ts> void ignore_variables(Ts&&...) {}
 void do_ignore_variables() {
   ignore_variables(
     vc1, vc2, l1, l2, l3, l4, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11,
-    b12, b13, cv1, cf1, cf2, cf3, cf4, s2, s3, s4
+    b12, b13, cv1, cf1, cf2, cf3, cf4, cf5, cf6, cf7, cf8, cf9,
+    r1, r2, r3, s2, s3, s4
   );
 }
@@ -0,0 +1,15 @@
+// The single flag is checked by an assert, which must be on here.
+#undef NDEBUG
+
+#include <flags/histogram.hpp>
+
+
+enum class Color : unsigned char { Red = 1, Green = 2, Blue = 4 };
+ALLOW_FLAGS_FOR_ENUM(Color)
+
+
+int main() {
+  flags::flag_counter<Color> counter;
+  counter.add(Color::Red | Color::Green);
+  return static_cast<int>(counter.count(static_cast<Color>(3)));
+}
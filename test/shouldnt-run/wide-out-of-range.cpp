@@ -0,0 +1,15 @@
+// The bound is checked by an assert, which must be on here.
+#undef NDEBUG
+
+#include <flags/wide_flags.hpp>
+
+
+enum class Capability : unsigned short { First = 0, Last = 299, Past = 300 };
+ALLOW_WIDE_FLAGS_FOR_ENUM(Capability)
+
+
+int main() {
+  flags::wide_flags<Capability, 300> fl{Capability::First};
+  fl.insert(Capability::Past);
+  return 0;
+}
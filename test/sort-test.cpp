@@ -0,0 +1,117 @@
+#include "common.hpp"
+
+#include <flags/sort.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Narrow : std::uint16_t {};
+ALLOW_FLAGS_FOR_ENUM(Narrow)
+
+void test_ordering() {
+  BOOST_TEST(Enums{Enum::One} < Enum::Two);
+  BOOST_TEST((Enum::One | Enum::Two) < Enums{Enum::Four});
+  BOOST_TEST(Enums{flags::empty} <= Enums{flags::empty});
+  BOOST_TEST(Enums{Enum::Eight} > (Enum::One | Enum::Two | Enum::Four));
+  BOOST_TEST(!(Enums{Enum::Two} >= (Enum::Two | Enum::One)));
+
+  // a set precedes its supersets in both orders
+  const flags::size_order by_size;
+  BOOST_TEST(by_size(Enums{Enum::Eight}, Enum::One | Enum::Two));
+  BOOST_TEST(by_size(Enum::One | Enum::Eight, Enum::Two | Enum::Eight));
+  BOOST_TEST(!by_size(Enums{Enum::Two}, Enums{Enum::Two}));
+
+  // values above the sign bit of the underlying type are still greater
+  BOOST_TEST(from_raw<Wide>(1ull << 63) > from_raw<Wide>(1));
+
+#ifdef ENUM_CLASS_FLAGS_HAS_THREE_WAY_COMPARISON
+  BOOST_TEST((Enums{Enum::One} <=> Enum::Two) < 0);
+#endif
+}
+
+
+template <class E> void check_sorts(std::size_t n, unsigned bits) {
+  auto values = make_values<E>(n, bits);
+  auto expected = values;
+  std::vector<flags::flags<E>> buffer(n);
+
+  std::sort(expected.begin(), expected.end());
+  flags::radix_sort(values.data(), values.data() + n, buffer.data());
+  BOOST_TEST(values == expected);
+
+  values = make_values<E>(n, bits);
+  expected = values;
+  std::sort(expected.begin(), expected.end(), flags::size_order{});
+  flags::radix_sort(values.data(), values.data() + n, buffer.data(),
+                    flags::size_order{});
+  BOOST_TEST(values == expected);
+}
+
+void test_radix_sort() {
+  for (std::size_t n : {0, 1, 10, 63, 64, 1000, 20000}) {
+    check_sorts<Wide>(n, 64);
+    check_sorts<Wide>(n, 12);
+    check_sorts<Wide>(n, 1);
+    check_sorts<Narrow>(n, 16);
+    check_sorts<SmallEnum>(n, 8);
+  }
+
+  // already equal everywhere: nothing moves
+  std::vector<Wides> same(500, from_raw<Wide>(42)), buffer(500);
+  flags::radix_sort(same.data(), same.data() + 500, buffer.data());
+  BOOST_TEST(same == std::vector<Wides>(500, from_raw<Wide>(42)));
+}
+
+
+void test_sort_unique() {
+  auto values = make_values<Wide>(5000, 9);
+  std::vector<Wides> buffer(values.size());
+  auto expected = values;
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()),
+                 expected.end());
+
+  const auto end = flags::sort_unique(values.data(),
+                                      values.data() + values.size(),
+                                      buffer.data());
+  BOOST_TEST(std::vector<Wides>(values.data(), end) == expected);
+}
+
+
+void test_group_by() {
+  const auto keys = make_values<Wide>(3000, 6);
+  std::vector<std::size_t> order(keys.size()), buffer(keys.size());
+  const auto groups = flags::group_by(keys.data(), keys.size(), order.data(),
+                                      buffer.data());
+  BOOST_TEST_EQ(std::set<Wides>(keys.begin(), keys.end()).size(), groups);
+
+  std::vector<std::size_t> expected(keys.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) { expected[i] = i; }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [&](std::size_t a, std::size_t b) {
+                     return keys[a] < keys[b];
+                   });
+  BOOST_TEST(order == expected);
+
+  // one key: the identity order
+  const std::vector<Wides> one(100, from_raw<Wide>(3));
+  BOOST_TEST_EQ(1u, flags::group_by(one.data(), one.size(), order.data(),
+                                    buffer.data()));
+  BOOST_TEST_EQ(99u, order[99]);
+  BOOST_TEST_EQ(0u, flags::group_by(one.data(), 0, order.data(),
+                                    buffer.data()));
+}
+
+
+int main() {
+  test_ordering();
+  test_radix_sort();
+  test_sort_unique();
+  test_group_by();
+  return boost::report_errors();
+}
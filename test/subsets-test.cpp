@@ -0,0 +1,133 @@
+#include "common.hpp"
+
+#include <flags/subsets.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+template <class Range>
+std::vector<typename Range::value_type> collect(const Range &range) {
+  std::vector<typename Range::value_type> result;
+  for (auto fl : range) { result.push_back(fl); }
+  return result;
+}
+
+
+void test_predicates() {
+  const Enums one_two = Enum::One | Enum::Two;
+  BOOST_TEST(Enums{Enum::One}.is_subset_of(one_two));
+  BOOST_TEST(one_two.is_subset_of(one_two));
+  BOOST_TEST(!one_two.is_subset_of(Enum::One));
+  BOOST_TEST(Enums{flags::empty}.is_subset_of(Enums{flags::empty}));
+
+  BOOST_TEST(one_two.is_superset_of(Enum::Two));
+  BOOST_TEST(!one_two.is_superset_of(Enum::Two | Enum::Four));
+
+  BOOST_TEST(one_two.intersects(Enum::Two | Enum::Eight));
+  BOOST_TEST(!one_two.intersects(Enum::Four | Enum::Eight));
+  BOOST_TEST(!one_two.intersects(Enums{flags::empty}));
+
+  static_assert(Enums(Enum::Four).is_subset_of(Enum::Four | Enum::Eight), "");
+}
+
+
+void test_subsets() {
+  const Enums mask = Enum::One | Enum::Four | Enum::Eight;
+  const auto all = collect(flags::subsets(mask));
+  BOOST_TEST_EQ(8u, all.size());
+  BOOST_TEST(all.front() == Enums{flags::empty});
+  BOOST_TEST(all.back() == mask);
+  for (std::size_t i = 1; i < all.size(); ++i) {
+    BOOST_TEST(all[i - 1] < all[i]);
+    BOOST_TEST(all[i].is_subset_of(mask));
+  }
+
+  BOOST_TEST_EQ(1u, collect(flags::subsets(Enums{flags::empty})).size());
+  BOOST_TEST_EQ(1u << 12,
+                collect(flags::subsets(from_raw<Wide>(0xf00000000f0000f0u)))
+                  .size());
+  BOOST_TEST(!flags::subsets(mask).empty());
+}
+
+
+void test_supersets() {
+  const Enums universe = Enum::One | Enum::Two | Enum::Eight;
+  const auto sets = collect(flags::supersets_within(Enums{Enum::Two},
+                                                    universe));
+  BOOST_TEST_EQ(4u, sets.size());
+  for (auto fl : sets) {
+    BOOST_TEST(fl.is_superset_of(Enum::Two));
+    BOOST_TEST(fl.is_subset_of(universe));
+  }
+  BOOST_TEST(sets.front() == Enum::Two);
+  BOOST_TEST(sets.back() == universe);
+
+  BOOST_TEST_EQ(1u, collect(flags::supersets_within(universe, universe))
+                      .size());
+  BOOST_TEST(flags::supersets_within(Enums{Enum::Four}, universe).empty());
+}
+
+
+void test_combinations() {
+  // every k and a sparse mask, against filtering all subsets by size
+  const Wides mask = from_raw<Wide>(0x8000100400030011u);
+  for (std::size_t k = 0; k <= 9; ++k) {
+    std::vector<Wides> expected;
+    for (auto fl : flags::subsets(mask)) {
+      if (fl.size() == k) { expected.push_back(fl); }
+    }
+    BOOST_TEST(collect(flags::combinations(mask, k)) == expected);
+  }
+
+  BOOST_TEST_EQ(0u, collect(flags::combinations(mask, 9)).size());
+  BOOST_TEST(flags::combinations(mask, 9).empty());
+  BOOST_TEST_EQ(1u, collect(flags::combinations(Enums{flags::empty}, 0))
+                      .size());
+
+  // the top bit of the underlying type and all of its bits
+  const Wides full = from_raw<Wide>(~0ull);
+  BOOST_TEST_EQ(64u, collect(flags::combinations(full, 1)).size());
+  BOOST_TEST_EQ(2016u, collect(flags::combinations(full, 2)).size());
+  const auto small = collect(flags::combinations(
+    SmallEnum::SmallOne | SmallEnum::SmallEight, 1));
+  BOOST_TEST_EQ(2u, small.size());
+
+  std::set<Wides> distinct;
+  for (auto fl : flags::combinations(from_raw<Wide>(0xffff), 8)) {
+    BOOST_TEST_EQ(8u, fl.size());
+    distinct.insert(fl);
+  }
+  BOOST_TEST_EQ(12870u, distinct.size());
+}
+
+
+#ifdef ENUM_CLASS_FLAGS_HAS_CONSTEXPR14
+constexpr std::size_t count_combinations(Enums fl, std::size_t k) {
+  std::size_t n = 0;
+  for (auto c : flags::combinations(fl, k)) { n += c.size() == k ? 1 : 0; }
+  return n;
+}
+
+constexpr std::size_t count_subsets(Enums fl) {
+  std::size_t n = 0;
+  for (auto s : flags::subsets(fl)) { n += s.is_subset_of(fl) ? 1 : 0; }
+  return n;
+}
+
+static_assert(count_combinations(Enum::One | Enum::Two | Enum::Eight, 2) == 3,
+              "");
+static_assert(count_subsets(Enum::One | Enum::Two | Enum::Eight) == 8, "");
+#endif
+
+
+int main() {
+  test_predicates();
+  test_subsets();
+  test_supersets();
+  test_combinations();
+  return boost::report_errors();
+}
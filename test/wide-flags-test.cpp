@@ -0,0 +1,159 @@
+#include <flags/wide_flags.hpp>
+
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class Capability : unsigned short { First = 0, Second = 1, Word = 64,
+                                         Middle = 150, Last = 299 };
+ALLOW_WIDE_FLAGS_FOR_ENUM(Capability)
+
+using Capabilities = flags::wide_flags<Capability, 300>;
+
+
+namespace flags {
+template <class E, std::size_t Bits>
+auto operator<<(std::ostream& o, const wide_flags<E, Bits> &fl)
+-> std::ostream& {
+  return o << "wide_flags<" << fl.to_bitset() << '>';
+}
+} // namespace flags
+
+
+void test_construction() {
+  const Capabilities none{flags::empty};
+  BOOST_TEST(none.empty());
+  BOOST_TEST_NOT(none);
+  BOOST_TEST_EQ(0u, none.size());
+  BOOST_TEST_EQ(5u, Capabilities::word_count());
+
+  const Capabilities one = Capability::Word;
+  BOOST_TEST_EQ(1u, one.size());
+  BOOST_TEST_EQ(1u, one.count(Capability::Word));
+  BOOST_TEST_EQ(0u, one.count(Capability::First));
+
+  const Capabilities il{Capability::First, Capability::Last};
+  const Capabilities variadic(Capability::First, Capability::Last);
+  BOOST_TEST_EQ(il, variadic);
+  BOOST_TEST_NE(il, one);
+
+  std::vector<Capability> vec = {Capability::Second, Capability::Middle};
+  const Capabilities ranged(vec.begin(), vec.end());
+  BOOST_TEST_EQ(2u, ranged.size());
+  BOOST_TEST(ranged.find(Capability::Middle) != ranged.end());
+}
+
+
+void test_bitwise() {
+  const Capabilities a{Capability::First, Capability::Word, Capability::Last};
+  const Capabilities b{Capability::Word, Capability::Middle};
+
+  BOOST_TEST_EQ((a | b).size(), 4u);
+  BOOST_TEST_EQ(a & b, Capabilities{Capability::Word});
+  BOOST_TEST_EQ(a ^ b, Capabilities(Capability::First, Capability::Middle,
+                                    Capability::Last));
+
+  // complement stays within the 300 valid bits:
+  const auto not_a = ~a;
+  BOOST_TEST_EQ(297u, not_a.size());
+  BOOST_TEST_EQ(300u, (a | not_a).size());
+  BOOST_TEST((a & not_a).empty());
+
+  Capabilities c = a;
+  c &= Capability::Last;
+  BOOST_TEST_EQ(c, Capabilities{Capability::Last});
+  c ^= Capability::Last;
+  BOOST_TEST(c.empty());
+  c |= Capability::Middle;
+  BOOST_TEST_EQ(c, Capabilities{Capability::Middle});
+
+  BOOST_TEST(a.any_of(b));
+  BOOST_TEST_NOT(a.all_of(b));
+  BOOST_TEST(a.all_of(Capability::Last));
+  BOOST_TEST(a.none_of(Capability::Middle));
+  BOOST_TEST_EQ(1u, a.count_in(b));
+}
+
+
+void test_iteration() {
+  const Capabilities fl{Capability::Last, Capability::First,
+                        Capability::Middle, Capability::Word};
+  std::vector<Capability> visited(fl.begin(), fl.end());
+  BOOST_TEST_EQ(4u, visited.size());
+  BOOST_TEST(visited[0] == Capability::First);
+  BOOST_TEST(visited[1] == Capability::Word);
+  BOOST_TEST(visited[2] == Capability::Middle);
+  BOOST_TEST(visited[3] == Capability::Last);
+
+  const Capabilities none{flags::empty};
+  BOOST_TEST(none.begin() == none.end());
+}
+
+
+void test_insert_erase() {
+  Capabilities fl{flags::empty};
+  BOOST_TEST(fl.insert(Capability::Middle).second);
+  BOOST_TEST_NOT(fl.insert(Capability::Middle).second);
+  fl |= Capabilities{Capability::First, Capability::Word, Capability::Last};
+  BOOST_TEST_EQ(4u, fl.size());
+
+  auto next = fl.erase(fl.find(Capability::Word));
+  BOOST_TEST(*next == Capability::Middle);
+  BOOST_TEST_EQ(3u, fl.size());
+
+  BOOST_TEST_EQ(1u, fl.erase(Capability::First));
+  BOOST_TEST_EQ(0u, fl.erase(Capability::First));
+
+  fl |= Capabilities{Capability::First, Capability::Second, Capability::Word};
+  auto last = fl.erase(fl.find(Capability::Second), fl.find(Capability::Last));
+  BOOST_TEST(*last == Capability::Last);
+  BOOST_TEST_EQ(fl, Capabilities(Capability::First, Capability::Last));
+
+  fl.erase(fl.begin(), fl.end());
+  BOOST_TEST(fl.empty());
+}
+
+
+void test_bounds() {
+  const Capabilities fl{Capability::First, Capability::Middle};
+
+  auto present = fl.equal_range(Capability::Middle);
+  BOOST_TEST(*present.first == Capability::Middle);
+  BOOST_TEST(present.second == fl.end());
+
+  // 300 bits is not a whole number of words, and Word is not in fl:
+  auto absent = fl.equal_range(Capability::Word);
+  BOOST_TEST(absent.first == absent.second);
+  BOOST_TEST(*absent.first == Capability::Middle);
+
+  auto last = fl.equal_range(Capability::Last);
+  BOOST_TEST(last.first == fl.end());
+  BOOST_TEST(last.second == fl.end());
+
+  BOOST_TEST(*fl.lower_bound(Capability::Second) == Capability::Middle);
+  BOOST_TEST(*fl.upper_bound(Capability::First) == Capability::Middle);
+  BOOST_TEST(fl.upper_bound(Capability::Middle) == fl.end());
+}
+
+
+void test_bitset() {
+  const Capabilities fl{Capability::Second, Capability::Word,
+                        Capability::Last};
+  const auto bits = fl.to_bitset();
+  BOOST_TEST_EQ(3u, bits.count());
+  BOOST_TEST(bits.test(1));
+  BOOST_TEST(bits.test(64));
+  BOOST_TEST(bits.test(299));
+}
+
+
+int main() {
+  test_construction();
+  test_bitwise();
+  test_iteration();
+  test_insert_erase();
+  test_bounds();
+  test_bitset();
+  return boost::report_errors();
+}
@@ -0,0 +1,185 @@
+#include "common.hpp"
+
+#include <flags/wire.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <boost/core/lightweight_test.hpp>
+
+
+enum class State : std::uint32_t {Idle = 1, Busy = 2, Error = 4, Paused = 8,
+                                  Stale = 16};
+ALLOW_FLAGS_FOR_ENUM_VALUES(State, Idle, Busy, Error, Paused, Stale)
+
+using States = flags::flags<State>;
+using flags::wire_option;
+
+
+const flags::wire_options all_options[] = {
+  flags::wire_options{flags::empty},
+  wire_option::delta,
+  wire_option::run_length,
+  wire_option::delta | wire_option::run_length,
+};
+
+
+// A state-change stream: long runs, each change flipping a bit or two.
+template <class E>
+std::vector<flags::flags<E>> make_stream(std::size_t n, unsigned width) {
+  std::mt19937_64 gen(n);
+  std::vector<flags::flags<E>> result;
+  std::uint64_t state = 0;
+  while (result.size() < n) {
+    state ^= std::uint64_t{1} << gen() % width;
+    if (gen() % 4 == 0) { state ^= std::uint64_t{1} << gen() % width; }
+    for (auto run = gen() % 20; run-- > 0 && result.size() < n;) {
+      result.push_back(from_raw<E>(state));
+    }
+  }
+  return result;
+}
+
+template <class E>
+void check_round_trip(const std::vector<flags::flags<E>> &values,
+                      flags::wire_options options) {
+  std::vector<unsigned char> buffer(flags::max_wire_size<E>(values.size()));
+  const auto e = flags::encode_wire(values.data(), values.size(),
+                                    buffer.data(),
+                                    buffer.data() + buffer.size(), options);
+  BOOST_TEST(e.ec == std::errc{});
+
+  std::vector<flags::flags<E>> decoded(values.size() + 1);
+  const auto d = flags::decode_wire(buffer.data(), e.ptr, decoded.data(),
+                                    decoded.size());
+  BOOST_TEST(d.ec == std::errc{});
+  BOOST_TEST(d.ptr == e.ptr);
+  BOOST_TEST_EQ(values.size(), d.count);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    BOOST_TEST(values[i] == decoded[i]);
+  }
+}
+
+
+void test_width() {
+  BOOST_TEST_EQ(5u, flags::wire_width<State>());
+  BOOST_TEST_EQ(64u, flags::wire_width<Wide>());
+
+  // 1000 values of 5 bits
+  const States values[] = {State::Busy, State::Idle | State::Stale};
+  unsigned char buffer[1024];
+  std::vector<States> many(1000, values[1]);
+  const auto e = flags::encode_wire(many.data(), many.size(), buffer,
+                                    buffer + sizeof(buffer));
+  BOOST_TEST_EQ(3 + 625, e.ptr - buffer);
+
+  const auto small = flags::encode_wire(values, 2, buffer, buffer + 4);
+  BOOST_TEST_EQ(4, small.ptr - buffer);
+  BOOST_TEST_EQ(4u << 2, buffer[0]);
+  BOOST_TEST_EQ(2u, buffer[1]);
+  BOOST_TEST_EQ((2u | 17u << 5) & 0xff, buffer[2]);
+  BOOST_TEST_EQ(17u >> 3, buffer[3]);
+}
+
+
+void test_round_trips() {
+  for (auto options : all_options) {
+    check_round_trip(std::vector<States>{}, options);
+    check_round_trip(make_stream<State>(1, 5), options);
+    check_round_trip(make_stream<State>(5000, 5), options);
+    check_round_trip(make_stream<Wide>(3000, 64), options);
+
+    // dense changes, taking the raw path of delta
+    std::mt19937_64 gen(7);
+    std::vector<flags::flags<Wide>> noise;
+    for (int i = 0; i < 500; ++i) { noise.push_back(from_raw<Wide>(gen())); }
+    check_round_trip(noise, options);
+  }
+}
+
+
+template <class E>
+std::vector<std::size_t> encoded_sizes(
+  const std::vector<flags::flags<E>> &values) {
+  std::vector<unsigned char> buffer(flags::max_wire_size<E>(values.size()));
+  std::vector<std::size_t> sizes;
+  for (auto options : all_options) {
+    const auto e = flags::encode_wire(values.data(), values.size(),
+                                      buffer.data(),
+                                      buffer.data() + buffer.size(), options);
+    sizes.push_back(static_cast<std::size_t>(e.ptr - buffer.data()));
+  }
+  return sizes;
+}
+
+void test_compression() {
+  // raw underlying values would take 40000 bytes
+  const auto narrow = encoded_sizes(make_stream<State>(10000, 5));
+  BOOST_TEST_LT(narrow[0], 6260u);
+  BOOST_TEST_LT(narrow[1], narrow[0]);
+  BOOST_TEST_LT(narrow[2], narrow[0] / 3);
+
+  // changes of a bit or two out of 64 are cheaper as indices
+  const auto wide = encoded_sizes(make_stream<Wide>(10000, 64));
+  BOOST_TEST_LT(wide[1], wide[0] / 4);
+  BOOST_TEST_LT(wide[3], wide[2]);
+}
+
+
+void test_errors() {
+  const auto values = make_stream<State>(300, 5);
+  unsigned char buffer[flags::max_wire_size<State>(300)];
+  const auto options = wire_option::delta | wire_option::run_length;
+
+  auto e = flags::encode_wire(values.data(), values.size(), buffer,
+                              buffer + 20, options);
+  BOOST_TEST(e.ec == std::errc::value_too_large);
+  e = flags::encode_wire(values.data(), values.size(), buffer,
+                         buffer + sizeof(buffer), options);
+
+  std::vector<States> decoded(300);
+  auto d = flags::decode_wire(buffer, e.ptr, decoded.data(), 299);
+  BOOST_TEST(d.ec == std::errc::value_too_large);
+  BOOST_TEST_EQ(300u, d.count);
+
+  d = flags::decode_wire(buffer, e.ptr - 3, decoded.data(), decoded.size());
+  BOOST_TEST(d.ec == std::errc::invalid_argument);
+  BOOST_TEST_LT(d.count, 300u);
+
+  // a wider stream than the enum can hold
+  const flags::flags<Wide> wide[] = {from_raw<Wide>(1ull << 40)};
+  e = flags::encode_wire(wide, 1, buffer, buffer + sizeof(buffer));
+  d = flags::decode_wire(buffer, e.ptr, decoded.data(), decoded.size());
+  BOOST_TEST(d.ec == std::errc::invalid_argument);
+}
+
+
+void test_stray_bits() {
+  // bits above the highest flag of State, which no options can encode
+  States stray = State::Busy;
+  stray.set_underlying_value(stray.underlying_value() | 0x60);
+  const std::vector<States> values = {State::Idle, stray, State::Error};
+  unsigned char buffer[flags::max_wire_size<State>(3)];
+  for (auto options : all_options) {
+    const auto e = flags::encode_wire(values.data(), values.size(), buffer,
+                                      buffer + sizeof(buffer), options);
+    BOOST_TEST(e.ec == std::errc::invalid_argument);
+    BOOST_TEST(e.ptr == buffer);
+
+    // without them, the value round-trips
+    check_round_trip(std::vector<States>{State::Idle, stray & States::all(),
+                                         State::Error},
+                     options);
+  }
+}
+
+
+int main() {
+  test_width();
+  test_round_trips();
+  test_compression();
+  test_errors();
+  test_stray_bits();
+  return boost::report_errors();
+}